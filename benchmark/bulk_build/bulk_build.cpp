@@ -0,0 +1,128 @@
+// Time the construction of the trace tree and the determinants of random configurations of
+// order 50 to 500 per block : in bulk with qmc_data::load_configuration (serial, and with
+// trace_rebuild_threads = hardware threads), and by replaying the insertions one pair at a time
+// as the insert move does. The test c++/bulk_build checks that both paths agree.
+#include <triqs_cthyb/qmc_data.hpp>
+
+#include <triqs/operators/many_body_operator.hpp>
+#include <triqs/hilbert_space/fundamental_operator_set.hpp>
+#include <triqs/gfs.hpp>
+#include <triqs/mpi/base.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+
+using namespace triqs_cthyb;
+using triqs::operators::n;
+using namespace triqs::gfs;
+using triqs::hilbert_space::fundamental_operator_set;
+using triqs::hilbert_space::gf_struct_t;
+
+// Shortest time of n_repeat calls of f, in seconds
+template <typename F> double best_time(int n_repeat, F f) {
+  double best = std::numeric_limits<double>::infinity();
+  for (int r = 0; r < n_repeat; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+
+  triqs::mpi::environment env(argc, argv);
+  int n_repeat = (argc > 1 ? std::atoi(argv[1]) : 5);
+
+  double beta = 10.0, U = 2.0, mu = 1.0, V = 2.0;
+  gf_struct_t gf_struct{{"up", {0}}, {"down", {0}}};
+
+  fundamental_operator_set fops;
+  std::map<std::pair<int, int>, int> linindex;
+  for (auto const &bl : gf_struct) fops.insert(bl.first, 0);
+  linindex[{0, 0}] = fops[{"up", 0}];
+  linindex[{1, 0}] = fops[{"down", 0}];
+
+  auto h_loc = U * n("up", 0) * n("down", 0) - mu * (n("up", 0) + n("down", 0));
+  atom_diag h_diag(h_loc, fops);
+
+  // Hybridization with a few bath levels
+  auto delta = block_gf<imtime>{{beta, Fermion, 2001}, gf_struct};
+  std::vector<double> eps{-2.0, -1.0, -0.3, 0.4, 1.2, 2.1};
+  for (auto &d : delta)
+    for (auto const &t : d.mesh()) {
+      double r = 0;
+      for (auto e : eps) r -= V * V / eps.size() * std::exp(-e * double(t)) / (1 + std::exp(-beta * e));
+      d[t] = r;
+    }
+
+  solve_parameters_t p(h_loc, 0);
+  solve_parameters_t p_threads    = p;
+  p_threads.trace_rebuild_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::mt19937 gen(1234);
+
+  std::cout << "Best of " << n_repeat << " builds, in seconds (" << p_threads.trace_rebuild_threads << " threads)" << std::endl;
+  std::cout << std::setw(8) << "order" << std::setw(14) << "bulk" << std::setw(14) << "bulk threads" << std::setw(14) << "replay"
+            << std::setw(14) << "speedup" << std::endl;
+
+  for (int order : {50, 100, 200, 300, 500}) {
+
+    // Random configuration with alternating creation/annihilation operators for each spin
+    config_snapshot_t ops;
+    for (int b = 0; b < 2; ++b) {
+      std::vector<double> taus(order);
+      std::uniform_real_distribution<double> dist(0.0, beta);
+      for (auto &t : taus) t = dist(gen);
+      std::sort(taus.begin(), taus.end(), std::greater<>{});
+      for (int i = 0; i < order; ++i) ops.emplace_back(taus[i], op_desc{b, 0, i % 2 == 0, linindex[{b, 0}]});
+    }
+    std::sort(ops.begin(), ops.end(), [](auto const &x, auto const &y) { return x.first > y.first; });
+
+    // Bulk
+    auto bulk = [&](solve_parameters_t const &q) {
+      qmc_data data(beta, q, h_diag, linindex, delta, {1, 1}, nullptr);
+      if (!data.load_configuration(ops)) TRIQS_RUNTIME_ERROR << "The random configuration has a vanishing weight";
+    };
+    double t_bulk         = best_time(n_repeat, [&]() { bulk(p); });
+    double t_bulk_threads = best_time(n_repeat, [&]() { bulk(p_threads); });
+
+    // Incremental replay, one (c^+, c) pair of neighbouring operators at a time
+    double t_replay = best_time(n_repeat, [&]() {
+      qmc_data inc(beta, p, h_diag, linindex, delta, {1, 1}, nullptr);
+      for (int b = 0; b < 2; ++b) {
+        config_snapshot_t block_ops;
+        for (auto const &op : ops)
+          if (op.second.block_index == b) block_ops.push_back(op);
+        for (int i = 0; i < block_ops.size(); i += 2) {
+          auto tau1 = inc.tau_seg.make_time_pt(block_ops[i].first), tau2 = inc.tau_seg.make_time_pt(block_ops[i + 1].first);
+          auto const &op1 = block_ops[i].second, &op2 = block_ops[i + 1].second;
+          inc.imp_trace.try_insert(tau1, op1);
+          inc.imp_trace.try_insert(tau2, op2);
+          auto &det = inc.dets[b];
+          int num_c_dag, num_c;
+          for (num_c_dag = 0; num_c_dag < det.size(); ++num_c_dag)
+            if (det.get_x(num_c_dag).first < tau1) break;
+          for (num_c = 0; num_c < det.size(); ++num_c)
+            if (det.get_y(num_c).first < tau2) break;
+          det.try_insert(num_c_dag, num_c, {tau1, 0}, {tau2, 0});
+          std::tie(inc.atomic_weight, inc.atomic_reweighting) = inc.imp_trace.compute();
+          inc.config.insert(tau1, op1);
+          inc.config.insert(tau2, op2);
+          inc.imp_trace.confirm_insert();
+          det.complete_operation();
+          inc.update_sign();
+        }
+      }
+    });
+
+    std::cout << std::setw(8) << order << std::setw(14) << t_bulk << std::setw(14) << t_bulk_threads << std::setw(14) << t_replay << std::setw(14)
+              << t_replay / std::min(t_bulk, t_bulk_threads) << std::endl;
+  }
+}
@@ -170,6 +170,11 @@ namespace triqs {
       int size() const { return size(root); }
       /// Is the tree empty?
       bool empty() const { return root == nullptr; }
+      /// Remove all nodes
+      void clear() {
+        rec_free(root);
+        root = nullptr;
+      }
       /// Get the root node
       node const &get_root() const { return root; }
       node &get_root() { return root; }
@@ -337,7 +342,53 @@ namespace triqs {
         check();
       }
 
+      /*************************************************************************
+  *  Bulk construction
+  *************************************************************************/
+      public:
+      // replace the content of the tree by n key-value pairs, sorted according to the comparator.
+      // kv(i) returns the i-th pair. The tree is balanced by construction, in O(n).
+      template <typename F> void build_sorted(int n, F const &kv) {
+        rec_free(root);
+        int h = 0; // black height : the largest h with 2^h - 1 <= n
+        while ((2l << h) - 1 <= n) ++h;
+        root = build_sorted(kv, 0, n, h);
+        if (root) root->color = BLACK;
+        check();
+      }
+
       private:
+      // build a subtree of black height h with the pairs [first, first + n)
+      // precondition : 2^h - 1 <= n <= 3^h - 1 (the sizes of 2-3 trees of height h)
+      template <typename F> node build_sorted(F const &kv, int first, int n, int h) {
+        if (n == 0) return nullptr;
+        auto make_node = [&kv](int i, bool color) {
+          auto p = kv(i);
+          return new node_t(p.first, p.second, color, 1);
+        };
+        long cap = 1; // largest subtree of black height h - 1
+        for (int i = 1; i < h; ++i) cap *= 3;
+        cap -= 1;
+        node x;
+        if (n - 1 <= 2 * cap) { // 2-node
+          int nl   = (n - 1) / 2;
+          x        = make_node(first + nl, BLACK);
+          x->left  = build_sorted(kv, first, nl, h - 1);
+          x->right = build_sorted(kv, first + nl + 1, n - 1 - nl, h - 1);
+        } else { // 3-node : a black node with a red left child
+          int m = n - 2, a = m / 3, b = (m - a) / 2, c = m - a - b;
+          node y   = make_node(first + a, RED);
+          y->left  = build_sorted(kv, first, a, h - 1);
+          y->right = build_sorted(kv, first + a + 1, b, h - 1);
+          y->N     = a + b + 1;
+          x        = make_node(first + a + b + 1, BLACK);
+          x->left  = y;
+          x->right = build_sorted(kv, first + a + b + 2, c, h - 1);
+        }
+        x->N = n;
+        return x;
+      }
+
       // insert the key-value pair in the subtree rooted at h
       node insert(node h, Key const &key, Value const &val) {
         if (h == nullptr) return new node_t(key, val, true, 1);
@@ -634,6 +685,12 @@ namespace triqs {
         return x->key;
       }
 
+      /// The node of rank k
+      node select_node(int k) const {
+        if (k < 0 || k >= size()) TRIQS_RUNTIME_ERROR << " unknow key";
+        return select(root, k);
+      }
+
       private:
       // the key of rank k in the subtree rooted at x
       node select(node x, int k) const {
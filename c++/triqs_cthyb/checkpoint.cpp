@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./checkpoint.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace triqs_cthyb {
+
+  namespace {
+
+    void write_configuration(triqs::h5::group g, config_snapshot_t const &ops) {
+      std::vector<double> tau;
+      std::vector<long> block_index, inner_index, dagger, linear_index;
+      for (auto const &[t, op] : ops) {
+        tau.push_back(t);
+        block_index.push_back(op.block_index);
+        inner_index.push_back(op.inner_index);
+        dagger.push_back(op.dagger);
+        linear_index.push_back(op.linear_index);
+      }
+      h5_write(g, "tau", tau);
+      h5_write(g, "block_index", block_index);
+      h5_write(g, "inner_index", inner_index);
+      h5_write(g, "dagger", dagger);
+      h5_write(g, "linear_index", linear_index);
+    }
+
+    config_snapshot_t read_configuration(triqs::h5::group g) {
+      std::vector<double> tau;
+      std::vector<long> block_index, inner_index, dagger, linear_index;
+      h5_read(g, "tau", tau);
+      h5_read(g, "block_index", block_index);
+      h5_read(g, "inner_index", inner_index);
+      h5_read(g, "dagger", dagger);
+      h5_read(g, "linear_index", linear_index);
+      config_snapshot_t ops;
+      for (int i = 0; i < tau.size(); ++i)
+        ops.emplace_back(tau[i], op_desc{int(block_index[i]), int(inner_index[i]), bool(dagger[i]), linear_index[i]});
+      return ops;
+    }
+
+  } // namespace
+
+  solve_checkpoint::solve_checkpoint(std::string filename, long interval_cycles, double interval_seconds)
+     : filename(std::move(filename)),
+       interval_cycles(interval_cycles),
+       interval_seconds(interval_seconds),
+       last_time(std::chrono::steady_clock::now()) {
+    if (interval_cycles <= 0 && interval_seconds <= 0) TRIQS_RUNTIME_ERROR << "solve_checkpoint: no interval between the checkpoints";
+    writer = std::thread([this]() { writer_loop(); });
+  }
+
+  solve_checkpoint::~solve_checkpoint() { stop_writer(); }
+
+  void solve_checkpoint::stop_writer() {
+    if (!writer.joinable()) return;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cv.notify_all();
+    writer.join();
+  }
+
+  // ------------------------------------------------------------------
+
+  bool solve_checkpoint::available() const { return bool(std::ifstream(filename)); }
+
+  void solve_checkpoint::load() {
+    triqs::h5::file f(filename, 'r');
+    triqs::h5::group g(f);
+    h5_read(g, "n_cycles", n_cycles_);
+    h5_read(g, "n_restarts", n_restarts_);
+    config_ = read_configuration(g.open_group("configuration"));
+    ++n_restarts_;
+    last_cycles = n_cycles_;
+  }
+
+  void solve_checkpoint::restore_measures() {
+    triqs::h5::file f(filename, 'r');
+    auto g = triqs::h5::group(f).open_group("measures");
+    for (auto const &m : measures) {
+      if (!g.has_key(m.name)) TRIQS_RUNTIME_ERROR << "The checkpoint " << filename << " has no accumulators for " << m.name;
+      m.read(g.open_group(m.name));
+    }
+  }
+
+  // ------------------------------------------------------------------
+
+  void solve_checkpoint::operator()(long n_cycles, triqs_cthyb::configuration const &config) {
+    auto now = std::chrono::steady_clock::now();
+    bool due = (interval_cycles > 0 && n_cycles - last_cycles >= interval_cycles)
+       || (interval_seconds > 0 && std::chrono::duration<double>(now - last_time).count() >= interval_seconds);
+    if (!due) return;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (busy || job) return; // the previous checkpoint is still being written, try again after the next cycle
+    }
+
+    // Copy everything now, the writer thread only sees the copies
+    std::vector<std::pair<std::string, state_writer_t>> states;
+    for (auto const &m : measures) states.emplace_back(m.name, m.copy());
+    auto new_job = [file = filename, n_cycles, n_restarts = n_restarts_, ops = config.snapshot(), states = std::move(states)]() {
+      auto tmp = file + ".tmp";
+      {
+        triqs::h5::file f(tmp, 'w');
+        triqs::h5::group g(f);
+        h5_write(g, "n_cycles", n_cycles);
+        h5_write(g, "n_restarts", n_restarts);
+        write_configuration(g.create_group("configuration"), ops);
+        auto gm = g.create_group("measures");
+        for (auto const &[name, write_state] : states) write_state(gm.create_group(name));
+      }
+      if (std::rename(tmp.c_str(), file.c_str()) != 0) std::cerr << "Warning: could not rename the checkpoint " << tmp << " to " << file << std::endl;
+    };
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      job = std::move(new_job);
+    }
+    cv.notify_all();
+    ++n_written_;
+    last_cycles = n_cycles;
+    last_time   = now;
+  }
+
+  void solve_checkpoint::complete() {
+    stop_writer();
+    std::remove(filename.c_str());
+    std::remove((filename + ".tmp").c_str());
+  }
+
+  void solve_checkpoint::writer_loop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      cv.wait(lock, [this]() { return stop || job; });
+      if (!job) return; // stop requested and nothing left to write
+      auto j = std::move(job);
+      job    = nullptr;
+      busy   = true;
+      lock.unlock();
+      try {
+        j();
+      } catch (std::exception const &e) { std::cerr << "Warning: writing the checkpoint " << filename << " failed: " << e.what() << std::endl; }
+      lock.lock();
+      busy = false;
+    }
+  }
+
+} // namespace triqs_cthyb
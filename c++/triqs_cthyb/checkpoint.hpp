@@ -0,0 +1,161 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./configuration.hpp"
+#include "./types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Checkpoints of a running solve
+
+   Every interval_cycles measured cycles and/or interval_seconds seconds, the
+   accumulators of the registered measures, the number of measured cycles and
+   the current configuration are copied and handed over to a background thread,
+   which writes them to an HDF5 file, so that the sampling is not stalled by the
+   writes. The file is written under a temporary name and renamed when complete.
+   A checkpoint due while the previous one is still being written is postponed.
+
+   On restart, the configuration and the accumulators are read back and the
+   sampling goes on from there. The state of the random number generator is
+   not accessible through mc_generic : every restart starts a new segment of
+   the Markov chain with its own seed, derived from the number of restarts.
+   A solve which measures all its cycles removes its checkpoint, so that a
+   later solve does not restart from the accumulators of another problem.
+   ********************************************/
+
+  /// A measure shared with the checkpoints, as added to mc_generic
+  template <typename M> struct checkpointed_measure {
+    std::shared_ptr<M> m;
+    void accumulate(mc_weight_t s) { m->accumulate(s); }
+    void collect_results(triqs::mpi::communicator const &c) { m->collect_results(c); }
+  };
+
+  class solve_checkpoint {
+
+    public:
+    solve_checkpoint(std::string filename, long interval_cycles, double interval_seconds);
+
+    solve_checkpoint(solve_checkpoint const &) = delete;
+    solve_checkpoint &operator=(solve_checkpoint const &) = delete;
+
+    /// Wait for the checkpoint being written, if any
+    ~solve_checkpoint();
+
+    /// Register the accumulators (m.accumulators()) of a measure under name, returns the measure to add to mc_generic
+    template <typename M> checkpointed_measure<std::decay_t<M>> add(std::string const &name, M &&m) {
+      auto p = std::make_shared<std::decay_t<M>>(std::forward<M>(m));
+      measures.push_back({name, [p]() { return copy_state(p->accumulators()); }, [p](triqs::h5::group g) { read_state(g, p->accumulators()); }});
+      return {p};
+    }
+
+    /// Is there a checkpoint file to restart from?
+    bool available() const;
+
+    /// Read the checkpoint file, once all ranks have agreed to restart from their checkpoints
+    void load();
+
+    /// Restore the accumulators of the registered measures from the loaded checkpoint
+    void restore_measures();
+
+    /// Measured cycles, number of restarts and configuration of the loaded checkpoint
+    long n_cycles() const { return n_cycles_; }
+    int n_restarts() const { return n_restarts_; }
+    config_snapshot_t const &configuration() const { return config_; }
+
+    /// To be called after every measured cycle, with the number of cycles measured since the start of the first segment
+    void operator()(long n_cycles, triqs_cthyb::configuration const &config);
+
+    /// Number of checkpoints handed over to the writer so far
+    long n_written() const { return n_written_; }
+
+    /// The solve is complete : wait for the checkpoint being written, if any, and remove the file
+    void complete();
+
+    private:
+    using state_writer_t = std::function<void(triqs::h5::group)>;
+
+    struct measure_entry {
+      std::string name;
+      std::function<state_writer_t()> copy; // copy of the accumulators, to be written later
+      std::function<void(triqs::h5::group)> read;
+    };
+
+    template <typename... T> static state_writer_t copy_state(std::tuple<T &...> t) {
+      auto copies = std::apply([](auto &... x) { return std::make_tuple(typename regular_type_of<std::decay_t<decltype(x)>>::type(x)...); }, t);
+      return [copies](triqs::h5::group g) {
+        std::apply(
+           [&g](auto const &... x) {
+             int i = 0;
+             (h5_write(g, std::to_string(i++), x), ...);
+           },
+           copies);
+      };
+    }
+
+    template <typename... T> static void read_state(triqs::h5::group g, std::tuple<T &...> t) {
+      std::apply(
+         [&g](auto &... x) {
+           int i = 0;
+           (read_one(g, std::to_string(i++), x), ...);
+         },
+         t);
+    }
+
+    template <typename T> static void read_one(triqs::h5::group g, std::string const &name, T &x) {
+      typename regular_type_of<T>::type r;
+      h5_read(g, name, r);
+      x = r;
+    }
+
+    void writer_loop();
+    void stop_writer();
+
+    std::string filename;
+    long interval_cycles;
+    double interval_seconds;
+    std::vector<measure_entry> measures;
+
+    long n_cycles_   = 0;
+    int n_restarts_  = 0;
+    long n_written_  = 0;
+    long last_cycles = 0;
+    std::chrono::steady_clock::time_point last_time;
+    config_snapshot_t config_;
+
+    std::function<void()> job; // the pending write
+    bool busy = false, stop = false;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::thread writer;
+  };
+
+} // namespace triqs_cthyb
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./config_stream.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace triqs_cthyb {
+
+  // Maximum number of full buffers waiting for the writer thread before the
+  // Monte Carlo thread has to wait
+  constexpr size_t max_pending_buffers = 4;
+
+  void write_to_stream(config_stream_writer &stream, configuration const &config, long step) { stream.write(config, step); }
+
+  // ------------------------------------------------------------------
+
+  config_stream_writer::config_stream_writer(std::string const &filename, double beta,
+                                             std::vector<std::pair<int, int>> const &lin_to_block_inner, size_t buffer_size)
+     : beta(beta), buffer_size(buffer_size), out(filename, std::ios::binary | std::ios::trunc) {
+
+    if (!out) TRIQS_RUNTIME_ERROR << "Could not open the configuration stream file " << filename;
+
+    uint32_t n_lin = lin_to_block_inner.size();
+    out.write(config_stream_magic, sizeof(config_stream_magic));
+    out.write(reinterpret_cast<const char *>(&config_stream_version), sizeof(uint32_t));
+    out.write(reinterpret_cast<const char *>(&beta), sizeof(double));
+    out.write(reinterpret_cast<const char *>(&n_lin), sizeof(uint32_t));
+    for (auto const &bi : lin_to_block_inner) {
+      int32_t b = bi.first, i = bi.second;
+      out.write(reinterpret_cast<const char *>(&b), sizeof(int32_t));
+      out.write(reinterpret_cast<const char *>(&i), sizeof(int32_t));
+    }
+
+    buffer.reserve(buffer_size + 64);
+    writer = std::thread([this]() { writer_loop(); });
+  }
+
+  config_stream_writer::~config_stream_writer() {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (!buffer.empty()) pending.push_back(std::move(buffer));
+      stop = true;
+    }
+    cv.notify_all();
+    writer.join();
+    out.close();
+  }
+
+  // ------------------------------------------------------------------
+
+  void config_stream_writer::put_varint(uint64_t x) {
+    while (x >= 0x80) {
+      buffer.push_back(uint8_t(x) | 0x80);
+      x >>= 7;
+    }
+    buffer.push_back(uint8_t(x));
+  }
+
+  void config_stream_writer::write(configuration const &config, long step) {
+
+    put_varint(step - last_step);
+    put_varint(config.size());
+    last_step = step;
+
+    uint64_t q_prev = config_stream_tau_max;
+    for (auto const &op : config) {
+      auto q = std::min(uint64_t(std::llround(double(op.first) / beta * config_stream_tau_max)), q_prev);
+      put_varint(q_prev - q);
+      put_varint((uint64_t(op.second.linear_index) << 1) | uint64_t(op.second.dagger));
+      q_prev = q;
+    }
+    ++n_records_;
+
+    if (buffer.size() >= buffer_size) hand_over_buffer();
+  }
+
+  void config_stream_writer::hand_over_buffer() {
+    std::unique_lock<std::mutex> lock(mtx);
+    // Back-pressure : do not let the queue grow without bound if the disk is slow
+    cv.wait(lock, [this]() { return pending.size() < max_pending_buffers; });
+    pending.push_back(std::move(buffer));
+    if (spare.empty()) {
+      buffer = std::vector<uint8_t>{};
+      buffer.reserve(buffer_size + 64);
+    } else {
+      buffer = std::move(spare.front());
+      spare.pop_front();
+    }
+    lock.unlock();
+    cv.notify_all();
+  }
+
+  void config_stream_writer::writer_loop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      cv.wait(lock, [this]() { return stop || !pending.empty(); });
+      if (pending.empty()) return; // stop requested and nothing left to write
+      auto buf = std::move(pending.front());
+      pending.pop_front();
+      lock.unlock();
+      cv.notify_all();
+      out.write(reinterpret_cast<const char *>(buf.data()), buf.size());
+      buf.clear();
+      lock.lock();
+      spare.push_back(std::move(buf));
+    }
+  }
+
+  // ------------------------------------------------------------------
+
+  config_stream_reader::config_stream_reader(std::string const &filename) : in(filename, std::ios::binary) {
+
+    if (!in) TRIQS_RUNTIME_ERROR << "Could not open the configuration stream file " << filename;
+
+    char magic[8];
+    uint32_t version, n_lin;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, config_stream_magic, sizeof(magic)) != 0)
+      TRIQS_RUNTIME_ERROR << filename << " is not a configuration stream file";
+    in.read(reinterpret_cast<char *>(&version), sizeof(uint32_t));
+    if (version != config_stream_version) TRIQS_RUNTIME_ERROR << "Unsupported configuration stream version " << version;
+    in.read(reinterpret_cast<char *>(&beta_), sizeof(double));
+    in.read(reinterpret_cast<char *>(&n_lin), sizeof(uint32_t));
+    lin_to_block_inner.resize(n_lin);
+    for (auto &bi : lin_to_block_inner) {
+      int32_t b, i;
+      in.read(reinterpret_cast<char *>(&b), sizeof(int32_t));
+      in.read(reinterpret_cast<char *>(&i), sizeof(int32_t));
+      bi = {b, i};
+    }
+    if (!in) TRIQS_RUNTIME_ERROR << "Truncated header in configuration stream " << filename;
+  }
+
+  uint64_t config_stream_reader::get_varint() {
+    uint64_t x = 0;
+    for (int shift = 0;; shift += 7) {
+      int c = in.get();
+      if (c == std::char_traits<char>::eof()) TRIQS_RUNTIME_ERROR << "Truncated record in configuration stream";
+      x |= uint64_t(c & 0x7f) << shift;
+      if (!(c & 0x80)) return x;
+    }
+  }
+
+  bool config_stream_reader::next(config_stream_record &rec) {
+    if (in.peek() == std::char_traits<char>::eof()) return false;
+
+    step += get_varint();
+    rec.step = step;
+    auto n_ops = get_varint();
+    rec.ops.clear();
+    rec.ops.reserve(n_ops);
+
+    uint64_t q = config_stream_tau_max;
+    for (uint64_t n = 0; n < n_ops; ++n) {
+      q -= get_varint();
+      auto packed = get_varint();
+      long lin    = packed >> 1;
+      if (lin >= lin_to_block_inner.size()) TRIQS_RUNTIME_ERROR << "Invalid linear index " << lin << " in configuration stream";
+      auto const &bi = lin_to_block_inner[lin];
+      rec.ops.emplace_back(double(q) / config_stream_tau_max * beta_, op_desc{bi.first, bi.second, bool(packed & 1), lin});
+    }
+    return true;
+  }
+
+} // namespace triqs_cthyb
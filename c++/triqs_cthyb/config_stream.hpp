@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./configuration.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Append-only binary stream of configurations
+
+   File layout ('v' denotes an unsigned LEB128 varint) :
+
+     header : char[8] "CTHYBCS1", uint32 version, double beta,
+              uint32 n_lin, n_lin x (int32 block_index, int32 inner_index)
+     record : v step increment, v number of operators,
+              n_ops x (v time increment, v (linear_index << 1 | dagger))
+
+   Operators are stored from the largest time down. Times are quantized as
+   tau / beta * 2^52 and each one is stored as its distance to the previous
+   operator (the first one as its distance to beta).
+   ********************************************/
+
+  constexpr char config_stream_magic[8]   = {'C', 'T', 'H', 'Y', 'B', 'C', 'S', '1'};
+  constexpr uint32_t config_stream_version = 1;
+  constexpr uint64_t config_stream_tau_max = uint64_t(1) << 52;
+
+  class config_stream_writer {
+
+    public:
+    /// Open the file and write the header. lin_to_block_inner maps a linear index to (block, inner).
+    config_stream_writer(std::string const &filename, double beta, std::vector<std::pair<int, int>> const &lin_to_block_inner,
+                         size_t buffer_size = 1 << 20);
+
+    config_stream_writer(config_stream_writer const &) = delete;
+    config_stream_writer &operator=(config_stream_writer const &) = delete;
+
+    /// Flush all pending buffers and close the file
+    ~config_stream_writer();
+
+    /// Encode a configuration visited at MC step 'step'
+    void write(configuration const &config, long step);
+
+    /// Number of configurations written so far
+    long n_records() const { return n_records_; }
+
+    private:
+    void put_varint(uint64_t x);
+    void hand_over_buffer(); // queue the current buffer for the writer thread
+    void writer_loop();
+
+    double beta;
+    size_t buffer_size;
+    long last_step  = 0;
+    long n_records_ = 0;
+
+    std::vector<uint8_t> buffer;                     // filled by the Monte Carlo thread
+    std::deque<std::vector<uint8_t>> pending, spare; // handed over to / given back by the writer thread
+    std::ofstream out;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stop = false;
+    std::thread writer;
+  };
+
+  // ------------------------------------------------------------------
+
+  /// A configuration read back from a stream
+  struct config_stream_record {
+    long step;
+    config_snapshot_t ops;
+  };
+
+  class config_stream_reader {
+
+    public:
+    config_stream_reader(std::string const &filename);
+
+    double beta() const { return beta_; }
+
+    /// Read the next configuration, returns false at the end of the stream
+    bool next(config_stream_record &rec);
+
+    private:
+    uint64_t get_varint();
+
+    double beta_;
+    long step = 0;
+    std::vector<std::pair<int, int>> lin_to_block_inner;
+    std::ifstream in;
+  };
+
+} // namespace triqs_cthyb
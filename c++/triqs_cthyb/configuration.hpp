@@ -19,13 +19,15 @@
  *
  ******************************************************************************/
 #pragma once
-#include "./util.hpp"
 #include <triqs/hilbert_space/hilbert_space.hpp>
 #include <triqs/utility/time_pt.hpp>
 #include <triqs/atom_diag/atom_diag.hpp>
 #include <triqs/atom_diag/functions.hpp>
 
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace triqs_cthyb {
 
@@ -51,20 +53,22 @@ namespace triqs_cthyb {
     }
   };
 
+  // A configuration as plain (tau, operator) pairs, from the largest time down
+  using config_snapshot_t = std::vector<std::pair<double, op_desc>>;
+
+  struct configuration;
+  class config_stream_writer;
+
+  // Append a configuration to a binary stream (see config_stream.hpp)
+  void write_to_stream(config_stream_writer &stream, configuration const &config, long step);
+
   // The configuration of the Monte Carlo
   struct configuration {
 
     // a map associating an operator to an imaginary time
     using oplist_t = std::map<time_pt, op_desc, std::greater<time_pt>>;
 
-#ifdef SAVE_CONFIGS
-    configuration(double beta) : beta_(beta), id(0), configs_hfile("configs.h5", exists("configs.h5") ? H5F_ACC_RDWR : H5F_ACC_TRUNC) {
-      if (NUM_CONFIGS_TO_SAVE > 0) h5_write(configs_hfile, "c_0", *this);
-    }
-    ~configuration() { configs_hfile.close(); }
-#else
     configuration(double beta) : beta_(beta), id(0) {}
-#endif
 
     double beta() const { return beta_; }
     int size() const { return oplist.size(); }
@@ -79,29 +83,29 @@ namespace triqs_cthyb {
     oplist_t::const_iterator begin() const { return oplist.begin(); }
     oplist_t::const_iterator end() const { return oplist.end(); }
 
+    // Copy of the operators, independent of the time grid
+    config_snapshot_t snapshot() const {
+      config_snapshot_t ops;
+      ops.reserve(oplist.size());
+      for (auto const &op : oplist) ops.emplace_back(double(op.first), op.second);
+      return ops;
+    }
+
     friend std::ostream &operator<<(std::ostream &out, configuration const &c) {
       for (auto const &op : c) out << "tau = " << op.first << " : " << op.second << std::endl;
       return out;
     }
 
-    // Writing of configuration out to a h5 for e.g. plotting
-    friend void h5_write(triqs::h5::group conf, std::string conf_group_name, configuration const &c) {
-      triqs::h5::group conf_group = conf.create_group(conf_group_name);
-      for (auto const &op : c) {
-        // create group for given tau
-        auto tau_group_name        = std::to_string(double(op.first));
-        triqs::h5::group tau_group = conf_group.create_group(tau_group_name);
-        // in tau subgroup, write operator info
-        h5_write(tau_group, op.second);
-      }
+    // Record every 'interval'-th configuration into a binary stream
+    void attach_stream(std::shared_ptr<config_stream_writer> s, long interval) {
+      stream          = std::move(s);
+      stream_interval = std::max(interval, 1l);
     }
 
     long get_id() const { return id; } // Get the id of the current configuration
     void finalize() {
       id++;
-#ifdef SAVE_CONFIGS
-      if (id < NUM_CONFIGS_TO_SAVE) h5_write(configs_hfile, "c_" + std::to_string(id), *this);
-#endif
+      if (stream && id % stream_interval == 0) write_to_stream(*stream, *this, id);
     }
 
     private:
@@ -109,9 +113,8 @@ namespace triqs_cthyb {
     double beta_;
     oplist_t oplist;
 
-#ifdef SAVE_CONFIGS
-    // HDF5 file to save configurations
-    triqs::h5::file configs_hfile;
-#endif
+    // Binary stream of visited configurations (optional)
+    std::shared_ptr<config_stream_writer> stream;
+    long stream_interval = 1;
   };
 }
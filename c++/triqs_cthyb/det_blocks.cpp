@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./det_blocks.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+#include <numeric>
+
+namespace triqs_cthyb {
+
+  det_block_structure make_det_block_structure(gf_struct_t const &gf_struct) {
+    det_block_structure s;
+    int b = 0;
+    for (auto const &bl : gf_struct) {
+      std::vector<int> in(bl.second.size());
+      std::iota(in.begin(), in.end(), 0);
+      s.gf_struct[bl.first] = bl.second;
+      s.gf_block_name.push_back(bl.first);
+      s.gf_block.push_back(b++);
+      s.inner.push_back(in);
+    }
+    return s;
+  }
+
+  // ------------------------------------------------------------------
+
+  det_block_structure make_det_block_structure(gf_struct_t const &gf_struct, block_gf_const_view<imtime> delta, double threshold,
+                                               many_body_op_t const &h_loc) {
+
+    // (Green's function block, orbital) of the operators of gf_struct
+    std::map<indices_type, std::pair<int, int>> position;
+    int b = 0;
+    for (auto const &bl : gf_struct) {
+      int i = 0;
+      for (auto const &a : bl.second) position[{bl.first, a}] = {b, i++};
+      ++b;
+    }
+
+    // Orbitals of a block whose occupation is changed by a monomial of h_loc are coupled by h_loc
+    std::vector<std::vector<std::vector<int>>> h_loc_links(gf_struct.size());
+    for (auto const &term : h_loc) {
+      std::map<std::pair<int, int>, int> charge;
+      for (auto const &op : term.monomial) {
+        auto it = position.find(op.indices);
+        if (it != position.end()) charge[it->second] += (op.dagger ? 1 : -1);
+      }
+      std::vector<std::vector<int>> moved(gf_struct.size());
+      for (auto const &[orb, q] : charge)
+        if (q != 0) moved[orb.first].push_back(orb.second);
+      for (int bb = 0; bb < moved.size(); ++bb)
+        if (moved[bb].size() > 1) h_loc_links[bb].push_back(moved[bb]);
+    }
+
+    // Orbitals of each determinant block, labelled by their Green's function block and name
+    std::map<std::string, std::pair<int, std::vector<int>>> groups;
+
+    b = 0;
+    for (auto const &bl : gf_struct) {
+      int n = bl.second.size();
+
+      // Connected components (union-find)
+      std::vector<int> root(n);
+      std::iota(root.begin(), root.end(), 0);
+      auto find = [&root](int i) {
+        while (root[i] != i) i = root[i] = root[root[i]];
+        return i;
+      };
+      auto const &d = delta[b].data();
+      double cutoff = threshold * max_element(abs(d));
+      for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j) {
+          double m = std::max(max_element(abs(d(range(), i, j))), max_element(abs(d(range(), j, i))));
+          if (m > cutoff) root[find(i)] = find(j);
+        }
+      for (auto const &orbs : h_loc_links[b])
+        for (int i : orbs) root[find(i)] = find(orbs[0]);
+
+      // Components in the order of their first orbital
+      std::vector<std::vector<int>> comps;
+      std::map<int, int> comp_of_root;
+      for (int i = 0; i < n; ++i) {
+        auto [it, is_new] = comp_of_root.insert({find(i), comps.size()});
+        if (is_new) comps.emplace_back();
+        comps[it->second].push_back(i);
+      }
+
+      for (int k = 0; k < comps.size(); ++k) {
+        auto name = (comps.size() == 1 ? bl.first : bl.first + "_" + std::to_string(k));
+        if (!groups.insert({name, {b, comps[k]}}).second)
+          TRIQS_RUNTIME_ERROR << "Splitting the block " << bl.first << " of the determinants gives the block name " << name
+                              << " which is already used";
+      }
+      ++b;
+    }
+
+    // gf_struct is a map : the determinant blocks are ordered by their names
+    det_block_structure s;
+    std::vector<std::string> gf_names;
+    for (auto const &bl : gf_struct) gf_names.push_back(bl.first);
+    for (auto const &[name, g] : groups) {
+      auto const &labels = gf_struct.at(gf_names[g.first]);
+      auto &det_labels   = s.gf_struct[name];
+      for (int i : g.second) det_labels.push_back(labels[i]);
+      s.gf_block_name.push_back(gf_names[g.first]);
+      s.gf_block.push_back(g.first);
+      s.inner.push_back(g.second);
+      if (g.second.size() != labels.size()) s.is_split = true;
+    }
+    return s;
+  }
+
+} // namespace triqs_cthyb
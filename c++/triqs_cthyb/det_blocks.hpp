@@ -0,0 +1,80 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Block structure of the determinants
+
+   A Green's function block whose hybridization matrix has (nearly) vanishing
+   elements between groups of orbitals is split into one determinant per group.
+   Each group is a connected component of the graph of orbitals linked by an
+   element |Delta_ij(tau)| larger than threshold * max|Delta(tau)| of the block,
+   or by a term of h_loc which moves an electron between them (hopping, spin
+   flip, pair hopping, ...), so that orbitals do not need to be contiguous in
+   the block. The neglected elements of Delta are dropped.
+   ********************************************/
+
+  struct det_block_structure {
+    gf_struct_t gf_struct;                  // Blocks of the determinants
+    std::vector<std::string> gf_block_name; // Green's function block of each determinant block
+    std::vector<int> gf_block;              // Position of this Green's function block in gf_struct
+    std::vector<std::vector<int>> inner;    // For each determinant block, the positions of its orbitals in the Green's function block
+    bool is_split = false;                  // Is any Green's function block split?
+  };
+
+  /// One determinant per Green's function block
+  det_block_structure make_det_block_structure(gf_struct_t const &gf_struct);
+
+  /// Split the blocks of gf_struct, dropping the elements of delta smaller than threshold relative to the largest one of the block.
+  /// Orbitals coupled by h_loc are kept together.
+  det_block_structure make_det_block_structure(gf_struct_t const &gf_struct, block_gf_const_view<imtime> delta, double threshold,
+                                               many_body_op_t const &h_loc);
+
+  /// Copy of the determinant blocks of g (g has the block structure of the Green's function)
+  template <typename Var, typename Target>
+  block_gf<Var, Target> restrict_to_det_blocks(block_gf_const_view<Var, Target> g, det_block_structure const &s) {
+    auto res = block_gf<Var, Target>{g[0].mesh(), s.gf_struct};
+    for (int d : range(res.size())) {
+      auto const &in = s.inner[d];
+      for (int i : range(in.size()))
+        for (int j : range(in.size())) res[d].data()(range(), i, j) = g[s.gf_block[d]].data()(range(), in[i], in[j]);
+    }
+    return res;
+  }
+
+  /// Inverse of restrict_to_det_blocks, the elements between different determinant blocks are set to 0
+  template <typename Var, typename Target>
+  void scatter_det_blocks(block_gf_view<Var, Target> g, block_gf_const_view<Var, Target> g_det, det_block_structure const &s) {
+    g() = 0;
+    for (int d : range(g_det.size())) {
+      auto const &in = s.inner[d];
+      for (int i : range(in.size()))
+        for (int j : range(in.size())) g[s.gf_block[d]].data()(range(), in[i], in[j]) = g_det[d].data()(range(), i, j);
+    }
+  }
+
+} // namespace triqs_cthyb
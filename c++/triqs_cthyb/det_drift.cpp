@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./det_drift.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace triqs_cthyb {
+
+  det_drift_monitor::det_drift_monitor(qmc_data &data, int interval, double tolerance, int max_interval)
+     : data(data), interval_(interval), max_interval(std::max(interval, max_interval)), tolerance(tolerance) {
+    if (interval < 1) TRIQS_RUNTIME_ERROR << "det_drift_monitor: the recomputation interval must be positive, not " << interval;
+    if (tolerance <= 0) TRIQS_RUNTIME_ERROR << "det_drift_monitor: the drift tolerance must be positive, not " << tolerance;
+    // We take over the fixed rate check done by det_manip
+    for (auto &det : data.dets) det.set_n_operations_before_check(std::numeric_limits<uint64_t>::max());
+  }
+
+  // ------------------------------------------------------------------
+
+  void det_drift_monitor::operator()() {
+    if (++n_cycles < interval_) return;
+    n_cycles = 0;
+    check();
+  }
+
+  // ------------------------------------------------------------------
+
+  double det_drift_monitor::check() {
+
+    double drift = 0;
+    for (auto &det : data.dets) {
+      if (det.size() == 0) continue;
+      auto inv_updated = det.inverse_matrix();
+      det.regenerate();
+      auto inv   = det.inverse_matrix();
+      double nrm = max_element(abs(inv));
+      if (nrm > 0) drift = std::max(drift, max_element(abs(inv_updated - inv)) / nrm);
+    }
+
+    ++n_checks_;
+    max_drift_ = std::max(max_drift_, drift);
+
+    if (drift > tolerance) {
+      ++n_over_tolerance_;
+      interval_ = std::max(1, interval_ / 2);
+    } else if (drift < tolerance / 16)
+      interval_ = std::min(max_interval, 2 * interval_);
+
+    return drift;
+  }
+
+  // ------------------------------------------------------------------
+
+  void det_drift_monitor::collect_results(triqs::mpi::communicator const &c) {
+    max_drift_        = mpi_all_reduce(max_drift_, c, 0, MPI_MAX);
+    n_checks_         = mpi_all_reduce(n_checks_, c);
+    n_over_tolerance_ = mpi_all_reduce(n_over_tolerance_, c);
+  }
+
+} // namespace triqs_cthyb
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./qmc_data.hpp"
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Periodic recomputation of the determinants
+
+   The inverse matrices of the determinants are updated with the fast
+   (Sherman-Morrison like) formulas at every accepted move. Every 'interval'
+   cycles they are recomputed from scratch and the largest relative deviation
+   between the updated and the fresh inverse is recorded. The interval is then
+   adapted : halved when the deviation exceeds the tolerance, doubled when it
+   stays well below it.
+   ********************************************/
+
+  class det_drift_monitor {
+
+    public:
+    /// interval : initial number of cycles between two recomputations
+    det_drift_monitor(qmc_data &data, int interval, double tolerance, int max_interval = 1 << 16);
+
+    /// To be called after every Monte Carlo cycle
+    void operator()();
+
+    /// Recompute all determinants now and adapt the interval, returns the largest relative deviation
+    double check();
+
+    /// Largest deviation over all ranks
+    void collect_results(triqs::mpi::communicator const &c);
+
+    int interval() const { return interval_; }
+    long n_checks() const { return n_checks_; }
+    long n_over_tolerance() const { return n_over_tolerance_; }
+    double max_drift() const { return max_drift_; }
+
+    private:
+    qmc_data &data;
+    int interval_, max_interval;
+    double tolerance;
+    int n_cycles           = 0; // cycles since the last recomputation
+    long n_checks_         = 0;
+    long n_over_tolerance_ = 0;
+    double max_drift_      = 0;
+  };
+
+} // namespace triqs_cthyb
@@ -22,7 +22,9 @@
 #include <triqs/arrays.hpp>
 #include <triqs/arrays/blas_lapack/dot.hpp>
 #include <algorithm>
+#include <future>
 #include <limits>
+#include <thread>
 #include <triqs/arrays/linalg/eigenelements.hpp>
 
 //#define CHECK_ALL
@@ -62,6 +64,7 @@ namespace triqs_cthyb {
 
     use_norm_as_weight     = p.use_norm_as_weight;
     measure_density_matrix = p.measure_density_matrix;
+    n_rebuild_tasks        = std::max(1, std::min<int>(p.trace_rebuild_threads, std::max(1u, std::thread::hardware_concurrency())));
     // init density_matrix block + bool
     for (int bl = 0; bl < n_blocks; ++bl) density_matrix[bl] = bool_and_matrix{false, matrix_t(get_block_dim(bl), get_block_dim(bl))};
 
@@ -231,6 +234,15 @@ namespace triqs_cthyb {
     if (n->delete_flag) TRIQS_RUNTIME_ERROR << " Internal Error: node flagged for deletion in cache update ";
     update_cache_impl(n->left);
     update_cache_impl(n->right);
+    update_node_cache(n);
+    // This is not necessary here as all modified nodes are "cleared"
+    //  by tree::clear_modified in the try/cancel/confirm set
+    // n->modified = false;
+  }
+
+  // --------------------------------
+
+  void impurity_trace::update_node_cache(node n) {
     n->cache.dtau_r = (n->right ? double(n->key - tree.min_key(n->right)) : 0);
     n->cache.dtau_l = (n->left ? double(tree.max_key(n->left) - n->key) : 0);
     for (int b = 0; b < n_blocks; ++b) {
@@ -239,9 +251,67 @@ namespace triqs_cthyb {
       n->cache.matrix_lnorms[b]     = r.second;
       n->cache.matrix_norm_valid[b] = false;
     }
-    // This is not necessary here as all modified nodes are "cleared"
-    //  by tree::clear_modified in the try/cancel/confirm set
-    // n->modified = false;
+  }
+
+  // --------------------------------
+
+  // On a freshly built tree, every node is modified. Clearing the flag as soon as the cache
+  // of a node is ready lets its parent use that cache instead of walking down the subtree again,
+  // so that the whole tree is done in one O(n) pass. Subtrees are independent and the top
+  // ones are dispatched to n_tasks - 1 other threads (trace_rebuild_threads, serial by default).
+  void impurity_trace::update_cache_bulk(node n, int n_tasks) {
+    if (n == nullptr) return;
+    if (n_tasks > 1 && n->N > 256) {
+      auto left = std::async(std::launch::async, [this, n, n_tasks]() { update_cache_bulk(n->left, n_tasks / 2); });
+      update_cache_bulk(n->right, n_tasks - n_tasks / 2);
+      left.get();
+    } else {
+      update_cache_bulk(n->left, 1);
+      update_cache_bulk(n->right, 1);
+    }
+    update_node_cache(n);
+    n->modified = false;
+  }
+
+  // --------------------------------
+
+  void impurity_trace::rebuild() {
+    if (!trial_nodes.is_index_reset() || !removed_nodes.empty() || !backup_nodes.is_index_reset())
+      TRIQS_RUNTIME_ERROR << "impurity_trace: rebuild() called in the middle of a move";
+    build_tree({config->begin(), config->end()});
+  }
+
+  void impurity_trace::build_tree(std::vector<std::pair<time_pt, op_desc>> const &ops) {
+    tree.build_sorted(ops.size(), [&](int i) { return std::make_pair(ops[i].first, node_data_t{ops[i].second, n_blocks}); });
+    update_cache_bulk(tree.get_root(), n_rebuild_tasks);
+    tree_size = tree.size();
+    tree.clear_modified();
+    check_cache_integrity();
+  }
+
+  // --------------------------------
+
+  // The current tree is moved aside, untouched, so that cancel_rebuild only swaps it back.
+  void impurity_trace::try_rebuild(std::vector<std::pair<time_pt, op_desc>> const &ops) {
+    if (!trial_nodes.is_index_reset() || !removed_nodes.empty() || !backup_nodes.is_index_reset() || rebuild_pending)
+      TRIQS_RUNTIME_ERROR << "impurity_trace: try_rebuild() called in the middle of a move";
+    std::swap(tree.get_root(), saved_tree.get_root());
+    saved_tree_size = tree_size;
+    rebuild_pending = true;
+    build_tree(ops);
+  }
+
+  void impurity_trace::confirm_rebuild() {
+    saved_tree.clear();
+    rebuild_pending = false;
+  }
+
+  void impurity_trace::cancel_rebuild() {
+    if (!rebuild_pending) return;
+    std::swap(tree.get_root(), saved_tree.get_root());
+    tree_size = saved_tree_size;
+    saved_tree.clear();
+    rebuild_pending = false;
   }
 
   // -------- Calculate the dtau for a given node to its left and right neighbours ----------------
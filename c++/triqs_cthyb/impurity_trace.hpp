@@ -42,6 +42,7 @@ namespace triqs_cthyb {
 
     bool use_norm_as_weight;
     bool measure_density_matrix;
+    int n_rebuild_tasks; // threads sharing the caches of a full rebuild of the tree
 
     public:
     // construct from the config, the diagonalization of h_loc, and parameters
@@ -107,6 +108,12 @@ namespace triqs_cthyb {
     // ---------------- Cache machinery ----------------
     void update_cache();
 
+    /// The operator of rank k, from the largest time down as in the configuration, in O(log n)
+    std::pair<time_pt, op_desc> get_operator(int k) const {
+      auto n = tree.select_node(k);
+      return {n->key, n->op};
+    }
+
     private:
     // The dimension of block b
     int get_block_dim(int b) const { return h_diag->get_subspace_dim(b); }
@@ -133,6 +140,8 @@ namespace triqs_cthyb {
     std::pair<int, matrix_t> compute_matrix(node n, int b);
 
     void update_cache_impl(node n);
+    void update_cache_bulk(node n, int n_tasks); // single bottom-up pass, n_tasks subtrees handled in parallel
+    void update_node_cache(node n);              // cache of n, assuming the caches of its children are up to date
     void update_dtau(node n);
 
     bool use_norm_of_matrices_in_cache = true; // When a matrix is computed in cache, its spectral radius replaces the norm estimate
@@ -427,7 +436,30 @@ namespace triqs_cthyb {
       check_cache_integrity();
     }
 
+    /*************************************************************************
+  * Full rebuild of the tree from the configuration
+  *************************************************************************/
+
+    // Drop the tree and rebuild it, with all caches, from *config (e.g. to start from a saved configuration)
+    void rebuild();
+
+    /*************************************************************************
+  * Trial rebuild of the tree, for moves changing the times of all operators
+  *************************************************************************/
+
+    // Build the tree of ops (sorted by decreasing time) in place of the current one, which is kept until confirm/cancel
+    void try_rebuild(std::vector<std::pair<time_pt, op_desc>> const &ops);
+    void confirm_rebuild();
+    void cancel_rebuild();
+
     private:
+    rb_tree_t saved_tree;         // the tree replaced by try_rebuild
+    int saved_tree_size  = 0;     // and its size
+    bool rebuild_pending = false; // is there a trial tree?
+
+    // Replace the content of the tree by ops, sorted by decreasing time, and compute all caches
+    void build_tree(std::vector<std::pair<time_pt, op_desc>> const &ops);
+
     // ---------------- Histograms ----------------
     struct histograms_t {
 
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./load_balance.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+
+namespace triqs_cthyb {
+
+  cycle_balancer::cycle_balancer(triqs::mpi::communicator const &c, long target, double interval)
+     : target(target), interval(interval), last(clock_t::now()) {
+    if (interval <= 0) TRIQS_RUNTIME_ERROR << "cycle_balancer: the interval between two exchanges must be positive, not " << interval;
+    MPI_Comm_dup(c.get(), &comm);
+    MPI_Comm_dup(c.get(), &finish_comm);
+  }
+
+  cycle_balancer::~cycle_balancer() {
+    MPI_Comm_free(&comm);
+    MPI_Comm_free(&finish_comm);
+  }
+
+  // ------------------------------------------------------------------
+
+  bool cycle_balancer::operator()(long n_done) {
+    if (pending) {
+      int done = 0;
+      MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      if (done) {
+        pending = false;
+        // all ranks see the same sum and take the same decision
+        if (global >= target) stop = true;
+      }
+    }
+    if (stop) return true;
+
+    auto now = clock_t::now();
+    if (!pending && std::chrono::duration<double>(now - last).count() >= interval) {
+      local = n_done;
+      MPI_Iallreduce(&local, &global, 1, MPI_LONG, MPI_SUM, comm, &request);
+      pending = true;
+      ++n_rounds;
+      last = now;
+    }
+    return false;
+  }
+
+  // ------------------------------------------------------------------
+
+  void cycle_balancer::finish() {
+    long max_rounds = 0;
+    MPI_Allreduce(&n_rounds, &max_rounds, 1, MPI_LONG, MPI_MAX, finish_comm);
+    // the exchanges are matched in order : start the ones this rank has missed
+    for (; n_rounds < max_rounds; ++n_rounds) {
+      if (pending) MPI_Wait(&request, MPI_STATUS_IGNORE);
+      MPI_Iallreduce(&local, &global, 1, MPI_LONG, MPI_SUM, comm, &request);
+      pending = true;
+    }
+    if (pending) MPI_Wait(&request, MPI_STATUS_IGNORE);
+    pending = false;
+  }
+
+} // namespace triqs_cthyb
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mpi/base.hpp>
+
+#include <chrono>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Sharing of a global number of cycles among the MPI ranks
+
+   Used as stop callback of the accumulation, with a (practically) unlimited
+   number of cycles on every rank. Every 'interval' seconds, the ranks start a
+   non-blocking sum of the number of cycles done so far. The first completed
+   sum reaching the target stops all ranks at the same exchange, so that the
+   faster ranks do more cycles and all ranks finish together.
+
+   The exchanges use their own communicators. Ranks stopped for another reason
+   (max_time, signal) may have started fewer exchanges : finish() completes
+   the missing ones on all ranks.
+   ********************************************/
+
+  class cycle_balancer {
+
+    public:
+    /// target : number of cycles summed over the ranks of c, interval : seconds between two exchanges
+    cycle_balancer(triqs::mpi::communicator const &c, long target, double interval);
+    ~cycle_balancer();
+
+    cycle_balancer(cycle_balancer const &) = delete;
+    cycle_balancer &operator=(cycle_balancer const &) = delete;
+
+    /// To be called after every cycle with the number of cycles done by this rank, returns true to stop
+    bool operator()(long n_done);
+
+    /// Complete the outstanding exchanges (collective), once the accumulation is over
+    void finish();
+
+    /// True if the ranks stopped because the target was reached
+    bool target_reached() const { return stop; }
+
+    /// Number of exchanges so far
+    long n_exchanges() const { return n_rounds; }
+
+    private:
+    using clock_t = std::chrono::steady_clock;
+
+    MPI_Comm comm, finish_comm;
+    long target;
+    double interval;
+    clock_t::time_point last;
+    MPI_Request request;
+    bool pending = false, stop = false;
+    long n_rounds = 0;
+    long local = 0, global = 0;
+  };
+
+} // namespace triqs_cthyb
@@ -20,6 +20,7 @@
  ******************************************************************************/
 
 #include "./G2_iw.hpp"
+#include "./rank_reduction.hpp"
 
 namespace triqs_cthyb {
 
@@ -87,7 +88,7 @@ namespace triqs_cthyb {
     s *= data.atomic_reweighting;
     average_sign += s;
 
-    auto nfft_fill = [this](det_type const &det, nfft_array_t<2, 2> &nfft_matrix) {
+    auto nfft_fill = [this](auto const &det, nfft_array_t<2, 2> &nfft_matrix) {
       const double beta = this->data.config.beta();
       foreach (det, [&nfft_matrix, beta](op_t const &x, op_t const &y, det_scalar_t M) {
         nfft_matrix.push_back({beta - double(x.first), double(y.first)}, {x.second, y.second}, M);
@@ -95,19 +96,21 @@ namespace triqs_cthyb {
         ;
     };
 
-    // Intermediate M matrices for all blocks
+    // Intermediate M matrices for all blocks, from the determinants of data or their snapshots if the measure is pipelined
     M() = 0;
-    for (auto bidx : range(M.size())) {
-      nfft_fill(data.dets[bidx], M_nfft(bidx));
-      M_nfft(bidx).flush();
-    }
-
-    for (auto &m : G2_measures()) {
+    G2_measures.with_dets(data, [&](auto const &dets) {
+      G2_measures.parallel_for(M.size(), [&](int bidx) {
+        nfft_fill(dets[bidx], M_nfft(bidx));
+        M_nfft(bidx).flush();
+      });
+    });
+
+    G2_measures.for_each_measure([&](G2_measure_t const &m) {
       auto G2_iw_block = G2_iw(m.b1.idx, m.b2.idx);
       bool diag_block  = (m.b1.idx == m.b2.idx);
       if (order == block_order::AABB || diag_block) accumulate_impl_AABB(G2_iw_block, s, M(m.b1.idx), M(m.b2.idx));
       if (order == block_order::ABBA || diag_block) accumulate_impl_ABBA(G2_iw_block, s, M(m.b1.idx), M(m.b2.idx));
-    }
+    });
   }
 
   // Index placeholders
@@ -199,9 +202,11 @@ namespace triqs_cthyb {
   // --
 
   template <G2_channel Channel> void measure_G2_iw<Channel>::collect_results(triqs::mpi::communicator const &com) {
-    average_sign = mpi_all_reduce(average_sign, com);
-    G2_iw        = mpi_all_reduce(G2_iw, com);
-    G2_iw = G2_iw / (real(average_sign) * data.config.beta());
+    rank_reduce(average_sign, com, G2_measures.ranks);
+    rank_reduce_blocks(G2_iw, com, G2_measures.ranks, [&](int i, int j) {
+      auto G2_iw_block = G2_iw(i, j);
+      G2_iw_block /= (real(average_sign) * data.config.beta());
+    });
   }
 
   template class measure_G2_iw<G2_channel::AllFermionic>;
@@ -42,6 +42,9 @@ namespace triqs_cthyb {
     void accumulate(mc_weight_t s);
     void collect_results(triqs::mpi::communicator const &c);
 
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(average_sign, G2_iw); }
+
     private:
     using M_block_type = block_gf<cartesian_product<imfreq, imfreq>, matrix_valued>;
     using M_type       = M_block_type::g_t;
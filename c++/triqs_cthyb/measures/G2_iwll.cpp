@@ -20,6 +20,7 @@
  ******************************************************************************/
 
 #include "./G2_iwll.hpp"
+#include "./rank_reduction.hpp"
 
 namespace triqs_cthyb {
 
@@ -68,47 +69,51 @@ namespace triqs_cthyb {
     double beta = data.config.beta();
     int n_l     = std::get<1>(G2_iwll(0, 0).mesh().components()).size();
 
-    for (auto const &m : G2_measures()) {
+    // Each block-measure pushes to its own nfft buffer
+    // The determinants of data, or their snapshots if the measure is pipelined
+    G2_measures.with_dets(data, [&](auto const &dets) {
+      G2_measures.for_each_measure([&](G2_measure_t const &m) {
 
-      if (data.dets[m.b1.idx].size() == 0 || data.dets[m.b2.idx].size() == 0) continue;
+        if (dets[m.b1.idx].size() == 0 || dets[m.b2.idx].size() == 0) return;
 
-      auto accumulate_impl = [&](op_t const &i, op_t const &j, op_t const &k, op_t const &l, mc_weight_t val) {
+        auto accumulate_impl = [&](op_t const &i, op_t const &j, op_t const &k, op_t const &l, mc_weight_t val) {
 
-        tilde_p_gen p_l1_gen(beta), p_l2_gen(beta);
-        double dtau = setup_times(p_l1_gen, p_l2_gen, i, j, k, l);
+          tilde_p_gen p_l1_gen(beta), p_l2_gen(beta);
+          double dtau = setup_times(p_l1_gen, p_l2_gen, i, j, k, l);
 
-        for (int l1 : range(n_l)) {
-          double p_l1 = p_l1_gen.next();
-          for (int l2 : range(n_l)) {
-            double p_l2 = p_l2_gen.next();
-            mini_vector<int, 6> vec{l1, l2, i.second, j.second, k.second, l.second};
-            nfft_buf(m.b1.idx, m.b2.idx).push_back({dtau}, vec, val * p_l1 * p_l2);
+          for (int l1 : range(n_l)) {
+            double p_l1 = p_l1_gen.next();
+            for (int l2 : range(n_l)) {
+              double p_l2 = p_l2_gen.next();
+              mini_vector<int, 6> vec{l1, l2, i.second, j.second, k.second, l.second};
+              nfft_buf(m.b1.idx, m.b2.idx).push_back({dtau}, vec, val * p_l1 * p_l2);
+            }
           }
-        }
-      };
+        };
 
-      bool diag_block = (m.b1.idx == m.b2.idx);
+        bool diag_block = (m.b1.idx == m.b2.idx);
 
-      // Perform the accumulation looping over both determinants
-      if (order == block_order::AABB || diag_block) {
-        foreach (data.dets[m.b1.idx], [&](op_t const &i, op_t const &j, mc_weight_t M_ij) {
-          foreach (data.dets[m.b2.idx], [&](op_t const &k, op_t const &l, mc_weight_t M_kl) {
-            accumulate_impl(i, j, k, l, s * M_ij * M_kl); // Accumulate in legendre-nfft buffer
+        // Perform the accumulation looping over both determinants
+        if (order == block_order::AABB || diag_block) {
+          foreach (dets[m.b1.idx], [&](op_t const &i, op_t const &j, mc_weight_t M_ij) {
+            foreach (dets[m.b2.idx], [&](op_t const &k, op_t const &l, mc_weight_t M_kl) {
+              accumulate_impl(i, j, k, l, s * M_ij * M_kl); // Accumulate in legendre-nfft buffer
+            })
+              ;
           })
             ;
-        })
-          ;
-      }
-      if (order == block_order::ABBA || diag_block) {
-        foreach (data.dets[m.b1.idx], [&](op_t const &i, op_t const &l, mc_weight_t M_il) {
-          foreach (data.dets[m.b2.idx], [&](op_t const &k, op_t const &j, mc_weight_t M_kj) {
-            accumulate_impl(i, j, k, l, -s * M_il * M_kj); // Accumulate in legendre-nfft buffer
+        }
+        if (order == block_order::ABBA || diag_block) {
+          foreach (dets[m.b1.idx], [&](op_t const &i, op_t const &l, mc_weight_t M_il) {
+            foreach (dets[m.b2.idx], [&](op_t const &k, op_t const &j, mc_weight_t M_kj) {
+              accumulate_impl(i, j, k, l, -s * M_il * M_kj); // Accumulate in legendre-nfft buffer
+            })
+              ;
           })
             ;
-        })
-          ;
-      }
-    }
+        }
+      });
+    });
   }
 
   template <>
@@ -129,13 +134,13 @@ namespace triqs_cthyb {
 
   template <G2_channel Channel> void measure_G2_iwll<Channel>::collect_results(triqs::mpi::communicator const &c) {
 
-    for (auto const &m : G2_measures()) { nfft_buf(m.b1.idx, m.b2.idx).flush(); }
+    G2_measures.for_each_measure([&](G2_measure_t const &m) { nfft_buf(m.b1.idx, m.b2.idx).flush(); });
 
-    G2_iwll = mpi_all_reduce(G2_iwll, c);
+    rank_reduce(average_sign, c, G2_measures.ranks);
 
-    average_sign = mpi_all_reduce(average_sign, c);
-
-    for (auto &G2_iwll_block : G2_iwll) {
+    // Each block is normalised as soon as it is reduced
+    rank_reduce_blocks(G2_iwll, c, G2_measures.ranks, [&](int i, int j) {
+      auto G2_iwll_block = G2_iwll(i, j);
 
       for (auto l : std::get<1>(G2_iwll_block.mesh().components())) {
         auto _   = all_t{};
@@ -145,7 +150,7 @@ namespace triqs_cthyb {
       }
 
       G2_iwll_block /= (real(average_sign) * data.config.beta());
-    }
+    });
   }
 
   template class measure_G2_iwll<G2_channel::PP>;
@@ -66,6 +66,12 @@ namespace triqs_cthyb {
     void accumulate(mc_weight_t s);
     void collect_results(triqs::mpi::communicator const &c);
 
+    /// The accumulated state (for the checkpoints), with the pending NFFT buffers flushed
+    auto accumulators() {
+      for (auto const &m : G2_measures()) { nfft_buf(m.b1.idx, m.b2.idx).flush(); }
+      return std::tie(average_sign, G2_iwll);
+    }
+
     // internal methods 
     double setup_times(tilde_p_gen & p_l1_gen, tilde_p_gen & p_l2_gen, op_t const & i, op_t const & j, op_t const & k, op_t const & l);
   };
@@ -20,6 +20,7 @@
  ******************************************************************************/
 
 #include "./G2_tau.hpp"
+#include "./rank_reduction.hpp"
 
 namespace triqs_cthyb {
 
@@ -47,55 +48,60 @@ namespace triqs_cthyb {
     sign *= data.atomic_reweighting;
     average_sign += sign;
 
-    // loop only over block-combinations that should be measured
-    for (auto &m : G2_measures()) {
+    // loop only over block-combinations that should be measured, each one writing to its own block
+    // The determinants of data, or their snapshots if the measure is pipelined
+    G2_measures.with_dets(data, [&](auto const &dets) {
+      G2_measures.for_each_measure([&](G2_measure_t const &m) {
 
-      auto G2_tau_block = G2_tau(m.b1.idx, m.b2.idx);
-      bool diag_block   = (m.b1.idx == m.b2.idx);
+        auto G2_tau_block = G2_tau(m.b1.idx, m.b2.idx);
+        bool diag_block   = (m.b1.idx == m.b2.idx);
 
-      foreach (data.dets[m.b1.idx], [&](auto const &i, auto const &j, auto const M_ij) {
-        foreach (data.dets[m.b2.idx], [&](auto const &k, auto const &l, auto const M_kl) {
+        foreach (dets[m.b1.idx], [&](auto const &i, auto const &j, auto const M_ij) {
+          foreach (dets[m.b2.idx], [&](auto const &k, auto const &l, auto const M_kl) {
 
-          // lambda for computing a single product term of M_ij and M_kl
-          auto compute_M2_product = [&](auto const &i, auto const &j, auto const &k, auto const &l, mc_weight_t sign) {
+            // lambda for computing a single product term of M_ij and M_kl
+            auto compute_M2_product = [&](auto const &i, auto const &j, auto const &k, auto const &l, mc_weight_t sign) {
 
-            double t1 = double(i.first - l.first);
-            double t2 = double(j.first - l.first);
-            double t3 = double(k.first - l.first);
+              double t1 = double(i.first - l.first);
+              double t2 = double(j.first - l.first);
+              double t3 = double(k.first - l.first);
 
-            // implicit beta-periodicity, but fix the sign properly
-            int sign_flips    = int(i.first < l.first) + int(j.first < l.first) + int(k.first < l.first);
-            mc_weight_t pre_factor = (sign_flips % 2 ? -sign : sign);
+              // implicit beta-periodicity, but fix the sign properly
+              int sign_flips    = int(i.first < l.first) + int(j.first < l.first) + int(k.first < l.first);
+              mc_weight_t pre_factor = (sign_flips % 2 ? -sign : sign);
 
-            G2_tau_block[closest_mesh_pt(t1, t2, t3)](i.second, j.second, k.second, l.second) += pre_factor * M_ij * M_kl;
-          };
+              G2_tau_block[closest_mesh_pt(t1, t2, t3)](i.second, j.second, k.second, l.second) += pre_factor * M_ij * M_kl;
+            };
 
-          if (order == block_order::AABB || diag_block) compute_M2_product(i, j, k, l, +sign);
-          if (order == block_order::ABBA || diag_block) compute_M2_product(i, l, k, j, -sign);
+            if (order == block_order::AABB || diag_block) compute_M2_product(i, j, k, l, +sign);
+            if (order == block_order::ABBA || diag_block) compute_M2_product(i, l, k, j, -sign);
 
+          })
+            ;
         })
           ;
-      })
-        ;
-    }
+      });
+    });
   }
 
   void measure_G2_tau::collect_results(triqs::mpi::communicator const &comm) {
 
-    average_sign = mpi_all_reduce(average_sign, comm);
-    G2_tau       = mpi_all_reduce(G2_tau, comm);
+    rank_reduce(average_sign, comm, G2_measures.ranks);
 
-    // Rescale sampled Green's function
     double beta = data.config.beta();
     double dtau = std::get<0>(G2_tau(0,0).mesh()).delta();
-    G2_tau = G2_tau / (real(average_sign) * beta * std::pow(dtau, 3));
-
-    // Account for
-    // the 1/2 smaller volume of the side bins,
-    // the 1/4 smaller volume of the edge bins, and
-    // the 1/8 smaller volume of the corner bins.
-    
-    for (auto &G2_tau_block : G2_tau) {
+
+    // Each block is normalised as soon as it is reduced
+    rank_reduce_blocks(G2_tau, comm, G2_measures.ranks, [&](int i, int j) {
+      auto G2_tau_block = G2_tau(i, j);
+
+      // Rescale sampled Green's function
+      G2_tau_block /= (real(average_sign) * beta * std::pow(dtau, 3));
+
+      // Account for
+      // the 1/2 smaller volume of the side bins,
+      // the 1/4 smaller volume of the edge bins, and
+      // the 1/8 smaller volume of the corner bins.
       auto _ = all_t{};
       int n  = std::get<0>(G2_tau_block.mesh().components()).size() - 1;
 
@@ -106,7 +112,7 @@ namespace triqs_cthyb {
       G2_tau_block[n, _, _] *= 2.0;
       G2_tau_block[_, n, _] *= 2.0;
       G2_tau_block[_, _, n] *= 2.0;
-    }
+    });
   }
 
 } // namespace triqs_cthyb
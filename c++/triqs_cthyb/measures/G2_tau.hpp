@@ -38,6 +38,9 @@ namespace triqs_cthyb {
     void accumulate(mc_weight_t sign);
     void collect_results(triqs::mpi::communicator const &comm);
 
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(average_sign, G2_tau); }
+
     private:
     qmc_data const &data;
     G2_tau_t::view_type G2_tau;
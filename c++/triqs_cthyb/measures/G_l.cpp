@@ -20,12 +20,14 @@
  ******************************************************************************/
 
 #include "G_l.hpp"
+#include "walker_reduction.hpp"
 
 namespace triqs_cthyb {
 
   using namespace triqs::gfs;
 
-  measure_G_l::measure_G_l(std::optional<G_l_t> &G_l_opt, qmc_data const &data, int n_l, gf_struct_t const &gf_struct) : data(data), average_sign(0) {
+  measure_G_l::measure_G_l(std::optional<G_l_t> &G_l_opt, qmc_data const &data, int n_l, gf_struct_t const &gf_struct, walker_reduction &reduction)
+     : data(data), reduction(reduction), average_sign(0) {
     G_l_opt = block_gf<legendre>{{data.config.beta(), Fermion, static_cast<size_t>(n_l)}, gf_struct};
     G_l.rebind(*G_l_opt);
     G_l() = 0.0;
@@ -58,8 +60,9 @@ namespace triqs_cthyb {
 
   void measure_G_l::collect_results(triqs::mpi::communicator const &c) {
 
-    average_sign = mpi_all_reduce(average_sign, c);
-    G_l          = mpi_all_reduce(G_l, c);
+    reduction.reduce(average_sign, c);
+    reduction.reduce(G_l, c);
+    if (reduction.merging()) return;
 
     double beta = data.config.beta();
 
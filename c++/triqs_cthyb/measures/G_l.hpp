@@ -27,16 +27,22 @@ namespace triqs_cthyb {
 
   using namespace triqs::gfs;
 
+  class walker_reduction;
+
   // Measure Legendre Green's function (all blocks)
   struct measure_G_l {
 
     public:
-    measure_G_l(std::optional<G_l_t> &G_l_opt, qmc_data const &data, int n_l, gf_struct_t const &gf_struct);
+    measure_G_l(std::optional<G_l_t> &G_l_opt, qmc_data const &data, int n_l, gf_struct_t const &gf_struct, walker_reduction &reduction);
     void accumulate(mc_weight_t s);
     void collect_results(triqs::mpi::communicator const &c);
 
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(average_sign, G_l); }
+
     private:
     qmc_data const &data;
+    walker_reduction &reduction;
     mc_weight_t average_sign;
     G_l_t::view_type G_l;
   };
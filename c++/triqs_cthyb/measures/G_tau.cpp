@@ -20,13 +20,15 @@
  ******************************************************************************/
 
 #include "./G_tau.hpp"
+#include "./walker_reduction.hpp"
 
 namespace triqs_cthyb {
 
   using namespace triqs::gfs;
 
-  measure_G_tau::measure_G_tau(std::optional<G_tau_G_target_t> &G_tau_opt, qmc_data const &data, int n_tau, gf_struct_t const & gf_struct)
-    : data(data), average_sign(0) {
+  measure_G_tau::measure_G_tau(std::optional<G_tau_G_target_t> &G_tau_opt, qmc_data const &data, int n_tau, gf_struct_t const & gf_struct,
+                               walker_reduction &reduction)
+    : data(data), reduction(reduction), average_sign(0) {
     G_tau_opt = block_gf<imtime, G_target_t>({data.config.beta(), Fermion, n_tau}, gf_struct);
     G_tau.rebind(*G_tau_opt);
     G_tau() = 0.0;
@@ -49,8 +51,9 @@ namespace triqs_cthyb {
 
   void measure_G_tau::collect_results(triqs::mpi::communicator const &c) {
 
-    G_tau        = mpi_all_reduce(G_tau, c);
-    average_sign = mpi_all_reduce(average_sign, c);
+    reduction.reduce(G_tau, c);
+    reduction.reduce(average_sign, c);
+    if (reduction.merging()) return;
 
     for (auto &G_tau_block : G_tau) {
       double beta = G_tau_block.mesh().domain().beta;
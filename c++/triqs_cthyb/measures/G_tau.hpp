@@ -28,16 +28,23 @@ namespace triqs_cthyb {
 
   using namespace triqs::gfs;
 
+  class walker_reduction;
+
   // Measure imaginary time Green's function (all blocks)
   class measure_G_tau {
 
     public:
-    measure_G_tau(std::optional<G_tau_G_target_t> &G_tau_opt, qmc_data const &data, int n_tau, gf_struct_t const &gf_struct);
+    measure_G_tau(std::optional<G_tau_G_target_t> &G_tau_opt, qmc_data const &data, int n_tau, gf_struct_t const &gf_struct,
+                  walker_reduction &reduction);
     void accumulate(mc_weight_t s);
     void collect_results(triqs::mpi::communicator const &c);
 
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(average_sign, G_tau); }
+
     private:
     qmc_data const &data;
+    walker_reduction &reduction;
     mc_weight_t average_sign;
     G_tau_G_target_t::view_type G_tau;
   };
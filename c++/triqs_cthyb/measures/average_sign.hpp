@@ -20,6 +20,7 @@
  ******************************************************************************/
 #pragma once
 #include "../qmc_data.hpp"
+#include "./walker_reduction.hpp"
 
 namespace triqs_cthyb {
 
@@ -27,9 +28,11 @@ namespace triqs_cthyb {
 
     qmc_data const &data;
     mc_weight_t &average_sign;
+    walker_reduction &reduction;
     mc_weight_t sign, z;
 
-    measure_average_sign(qmc_data const &data, mc_weight_t &average_sign) : data(data), average_sign(average_sign) {
+    measure_average_sign(qmc_data const &data, mc_weight_t &average_sign, walker_reduction &reduction)
+       : data(data), average_sign(average_sign), reduction(reduction) {
       average_sign = 1.0;
       z            = 0;
       sign         = 0;
@@ -45,9 +48,14 @@ namespace triqs_cthyb {
 
     void collect_results(triqs::mpi::communicator const &c) {
 
-      z            = mpi_all_reduce(z, c);
-      sign         = mpi_all_reduce(sign, c);
+      reduction.reduce(z, c);
+      reduction.reduce(sign, c);
       average_sign = sign / z;
     }
+
+    // ---------------------------------------------
+
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(sign, z); }
   };
 }
@@ -19,13 +19,15 @@
  *
  ******************************************************************************/
 #include "./density_matrix.hpp"
+#include "./walker_reduction.hpp"
 #include <triqs/mpi/vector.hpp>
 
 #include <iomanip>
 
 namespace triqs_cthyb {
 
-  measure_density_matrix::measure_density_matrix(qmc_data const &data, std::vector<matrix_t> &density_matrix) : data(data), block_dm(density_matrix) {
+  measure_density_matrix::measure_density_matrix(qmc_data const &data, std::vector<matrix_t> &density_matrix, walker_reduction &reduction)
+     : data(data), block_dm(density_matrix), reduction(reduction) {
     block_dm.resize(data.imp_trace.get_density_matrix().size());
     for (int i = 0; i < block_dm.size(); ++i) {
       block_dm[i]   = data.imp_trace.get_density_matrix()[i].mat;
@@ -54,8 +56,9 @@ namespace triqs_cthyb {
 
   void measure_density_matrix::collect_results(triqs::mpi::communicator const &c) {
 
-    z                          = mpi_all_reduce(z, c);
-    block_dm                   = mpi_all_reduce(block_dm, c);
+    reduction.reduce(z, c);
+    reduction.reduce(block_dm, c);
+    if (reduction.merging()) return;
     for (auto &b : block_dm) b = b / real(z);
 
     if (c.rank() != 0) return;
@@ -23,13 +23,19 @@
 
 namespace triqs_cthyb {
 
+  class walker_reduction;
+
   struct measure_density_matrix {
     qmc_data const &data;
     std::vector<matrix_t> &block_dm; // density matrix of each block
+    walker_reduction &reduction;
     mc_weight_t z = 0;
 
-    measure_density_matrix(qmc_data const &data, std::vector<matrix_t> &density_matrix);
+    measure_density_matrix(qmc_data const &data, std::vector<matrix_t> &density_matrix, walker_reduction &reduction);
     void accumulate(mc_weight_t s);
     void collect_results(triqs::mpi::communicator const &c);
+
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(z, block_dm); }
   };
 }
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "../qmc_data.hpp"
+
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Compact copy of a determinant, as read by the two-particle measures
+
+   The times and inner indices of the rows (x) and columns (y) of M, and
+   its inverse. fill() reuses the buffers of the previous copy, so that
+   copying a determinant of a size seen before does not allocate.
+   foreach visits the elements of M^{-1} as it does for det_manip.
+   ********************************************/
+
+  struct det_snapshot {
+    std::vector<op_t> x, y;
+    std::vector<det_scalar_t> inverse; // M^{-1}_{ji} at j * size() + i
+
+    int size() const { return x.size(); }
+
+    void fill(det_type const &det) {
+      int n = det.size();
+      x.resize(n);
+      y.resize(n);
+      inverse.resize(n * n);
+      for (int i = 0; i < n; ++i) {
+        x[i] = det.get_x(i);
+        y[i] = det.get_y(i);
+      }
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i) inverse[j * n + i] = det.inverse_matrix(j, i);
+    }
+  };
+
+  /// Call f(x_i, y_j, M^{-1}_{ji}) for all i, j
+  template <typename F> void foreach (det_snapshot const &d, F const &f) {
+    int n = d.size();
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j) f(d.x[i], d.y[j], d.inverse[j * n + i]);
+  }
+
+} // namespace triqs_cthyb
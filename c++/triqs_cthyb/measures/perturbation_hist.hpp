@@ -20,6 +20,7 @@
  ******************************************************************************/
 #pragma once
 #include "../qmc_data.hpp"
+#include "./walker_reduction.hpp"
 #include <triqs/statistics/histograms.hpp>
 
 namespace triqs_cthyb {
@@ -29,15 +30,19 @@ namespace triqs_cthyb {
     qmc_data const &data;
     int block_index;
     statistics::histogram &histo_perturbation_order;
+    walker_reduction &reduction;
 
-    measure_perturbation_hist(int block_index, qmc_data const &data, statistics::histogram &hist)
-       : data(data), block_index(block_index), histo_perturbation_order(hist) {
+    measure_perturbation_hist(int block_index, qmc_data const &data, statistics::histogram &hist, walker_reduction &reduction)
+       : data(data), block_index(block_index), histo_perturbation_order(hist), reduction(reduction) {
       histo_perturbation_order = {0, 1000};
     }
 
     void accumulate(mc_weight_t s) { histo_perturbation_order << data.dets[block_index].size(); }
 
-    void collect_results(triqs::mpi::communicator const &c) { histo_perturbation_order = mpi_all_reduce(histo_perturbation_order, c); }
+    void collect_results(triqs::mpi::communicator const &c) { reduction.reduce(histo_perturbation_order, c); }
+
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(histo_perturbation_order); }
   };
 
   // -----------------------------------------------------------------------------
@@ -45,13 +50,18 @@ namespace triqs_cthyb {
 
     qmc_data const &data;
     statistics::histogram &histo_perturbation_order;
+    walker_reduction &reduction;
 
-    measure_perturbation_hist_total(qmc_data const &data, statistics::histogram &hist) : data(data), histo_perturbation_order(hist) {
+    measure_perturbation_hist_total(qmc_data const &data, statistics::histogram &hist, walker_reduction &reduction)
+       : data(data), histo_perturbation_order(hist), reduction(reduction) {
       histo_perturbation_order = {0, 1000};
     }
 
     void accumulate(mc_weight_t s) { histo_perturbation_order << data.config.size() / 2; }
 
-    void collect_results(triqs::mpi::communicator const &c) { histo_perturbation_order = mpi_all_reduce(histo_perturbation_order, c); }
+    void collect_results(triqs::mpi::communicator const &c) { reduction.reduce(histo_perturbation_order, c); }
+
+    /// The accumulated state (for the checkpoints)
+    auto accumulators() { return std::tie(histo_perturbation_order); }
   };
 }
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./pipeline.hpp"
+
+#include <utility>
+
+namespace triqs_cthyb {
+
+  measure_pipeline::measure_pipeline(qmc_data const &data, solve_parameters_t const &p, int depth) {
+    if (depth < 1) TRIQS_RUNTIME_ERROR << "measure_pipeline: the ring buffer needs at least one slot";
+    st = std::make_shared<state_t>(data, p, depth);
+  }
+
+  measure_pipeline::state_t::~state_t() { stop_worker(); }
+
+  // ------------------------------------------------------------------
+
+  void measure_pipeline::state_t::fill(slot_t &slot, mc_weight_t s) {
+    for (int b = 0; b < data.dets.size(); ++b) slot.dets[b].fill(data.dets[b]);
+    slot.atomic_reweighting = data.atomic_reweighting;
+    slot.sign               = s;
+  }
+
+  void measure_pipeline::state_t::process(slot_t &slot) {
+    std::swap(shadow_dets, slot.dets); // the buffers of the previous snapshot go back to the slot
+    shadow.atomic_reweighting = slot.atomic_reweighting;
+    for (auto const &a : accumulates) a(slot.sign);
+  }
+
+  void measure_pipeline::state_t::worker_loop() {
+    try {
+      while (true) {
+        long t = tail.load(std::memory_order_relaxed);
+        wait(cv_work, [&]() { return head.load(std::memory_order_acquire) != t || stop; });
+        if (t == head.load(std::memory_order_acquire)) return; // stopped, with no pending slot
+        process(slots[t % slots.size()]);
+        tail.store(t + 1, std::memory_order_release);
+        notify(cv_idle);
+      }
+    } catch (...) {
+      error  = std::current_exception();
+      failed = true;
+      notify(cv_idle);
+    }
+  }
+
+  void measure_pipeline::state_t::stop_worker() {
+    stop = true;
+    notify(cv_work);
+    if (worker.joinable()) worker.join();
+  }
+
+  void measure_pipeline::state_t::finish() {
+    stop_worker();
+    if (failed) std::rethrow_exception(std::exchange(error, nullptr));
+  }
+
+  // ------------------------------------------------------------------
+
+  void measure_pipeline::accumulate(mc_weight_t s) {
+    auto &S = *st;
+    if (!S.worker.joinable() && !S.stop) S.worker = std::thread([&S]() { S.worker_loop(); });
+    if (S.failed) S.finish();
+    ++S.n_snapshots;
+
+    long h     = S.head.load(std::memory_order_relaxed);
+    auto &slot = S.slots[h % S.slots.size()];
+
+    // Full ring buffer : wait for the worker to be idle, and measure here
+    if (h - S.tail.load(std::memory_order_acquire) == long(S.slots.size())) {
+      S.wait(S.cv_idle, [&]() { return S.tail.load(std::memory_order_acquire) == h || S.failed; });
+      if (S.failed) S.finish();
+      S.fill(slot, s);
+      S.process(slot);
+      ++S.n_synchronous;
+      return;
+    }
+
+    S.fill(slot, s);
+    S.head.store(h + 1, std::memory_order_release);
+    S.notify(S.cv_work);
+  }
+
+  void measure_pipeline::collect_results(triqs::mpi::communicator const &c) {
+    st->finish();
+    for (auto const &collect : st->collects) collect(c);
+  }
+
+} // namespace triqs_cthyb
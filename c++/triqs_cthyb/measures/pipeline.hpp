@@ -0,0 +1,138 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "../qmc_data.hpp"
+#include "./det_snapshot.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Measures accumulated on a worker thread
+
+   The measures added to the pipeline read a shadow qmc_data instead of the
+   data of the Markov chain. At every measurement, accumulate() copies the
+   determinants (their inverse matrices and their times, see det_snapshot),
+   the reweighting and the sign into the next slot of a single-producer
+   single-consumer ring buffer, and the sampling goes on. The buffers of the
+   slots are allocated once and reused. The worker thread swaps each slot
+   into the shadow and runs the measures on it : they read the determinants
+   from dets() (G2_measures_t::dets) instead of those of the shadow.
+
+   The worker, and accumulate() waiting for it, spin for a few rounds and
+   then sleep on a condition variable until head or tail moves.
+
+   If the ring buffer is full, the worker has fallen behind : accumulate()
+   waits for it to process all the pending slots, and runs the measures on
+   the current snapshot itself (synchronous mode). collect_results() waits
+   for the pending slots, stops the worker and collects the measures in the
+   order they were added.
+   ********************************************/
+
+  class measure_pipeline {
+
+    public:
+    /// depth : number of slots of the ring buffer
+    measure_pipeline(qmc_data const &data, solve_parameters_t const &p, int depth);
+
+    /// The data to be read by the measures of the pipeline
+    qmc_data const &shadow() const { return st->shadow; }
+
+    /// The snapshots of the determinants to be read by the measures of the pipeline, instead of shadow().dets
+    std::vector<det_snapshot> const &dets() const { return st->shadow_dets; }
+
+    /// Add a measure reading the shadow data, before the first accumulate
+    template <typename M> void add(M &&m) {
+      auto p = std::make_shared<std::decay_t<M>>(std::forward<M>(m));
+      st->accumulates.push_back([p](mc_weight_t s) { p->accumulate(s); });
+      st->collects.push_back([p](triqs::mpi::communicator const &c) { p->collect_results(c); });
+    }
+
+    void accumulate(mc_weight_t s);
+    void collect_results(triqs::mpi::communicator const &c);
+
+    /// Number of snapshots measured, and number of those measured synchronously by the sampling thread
+    long n_snapshots() const { return st->n_snapshots; }
+    long n_synchronous() const { return st->n_synchronous; }
+
+    private:
+    struct slot_t {
+      std::vector<det_snapshot> dets;
+      h_scalar_t atomic_reweighting;
+      mc_weight_t sign;
+    };
+
+    // Shared by the copies of the pipeline (the one added to mc_generic and the one of the caller)
+    struct state_t {
+      qmc_data const &data;
+      qmc_data shadow; // sharing the atomic problem and the Delta tables with data
+      std::vector<det_snapshot> shadow_dets;
+      std::vector<slot_t> slots;
+      std::vector<std::function<void(mc_weight_t)>> accumulates;
+      std::vector<std::function<void(triqs::mpi::communicator const &)>> collects;
+
+      std::atomic<long> head{0}, tail{0}; // slots written by the sampling thread, slots processed by the worker
+      std::atomic<bool> stop{false}, failed{false};
+      std::mutex mutex;
+      std::condition_variable cv_work, cv_idle; // head moved or stop, tail moved or failed
+      std::exception_ptr error;
+      std::thread worker;
+      long n_snapshots = 0, n_synchronous = 0;
+
+      state_t(qmc_data const &data, solve_parameters_t const &p, int depth)
+        : data(data), shadow(data, p, nullptr), shadow_dets(data.dets.size()), slots(depth, slot_t{shadow_dets}) {}
+      ~state_t();
+
+      void fill(slot_t &slot, mc_weight_t s);
+      void process(slot_t &slot);
+      void worker_loop();
+      void stop_worker();
+      void finish(); // process the pending slots and stop the worker
+
+      // Spin for a few rounds, then sleep on cv until ready()
+      template <typename F> void wait(std::condition_variable &cv, F ready) {
+        for (int n = 0; n < 64; ++n) {
+          if (ready()) return;
+          std::this_thread::yield();
+        }
+        std::unique_lock lock(mutex);
+        cv.wait(lock, ready);
+      }
+
+      // Wake up a thread waiting on cv, once the atomic it waits for has changed
+      void notify(std::condition_variable &cv) {
+        { std::lock_guard lock(mutex); } // no wakeup lost between the check of ready() and the sleep
+        cv.notify_one();
+      }
+    };
+
+    std::shared_ptr<state_t> st;
+  };
+
+} // namespace triqs_cthyb
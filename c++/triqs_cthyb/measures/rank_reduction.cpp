@@ -0,0 +1,40 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./rank_reduction.hpp"
+
+namespace triqs_cthyb {
+
+  rank_reduction::rank_reduction(triqs::mpi::communicator const &c, bool all_ranks, bool async) : world(c), all_ranks_(all_ranks), async_(async) {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(world.get(), MPI_COMM_TYPE_SHARED, world.rank(), MPI_INFO_NULL, &node_comm);
+    node = triqs::mpi::communicator(node_comm);
+
+    // The first rank of the node with rank 0 of c is rank 0 of the leaders
+    leaders       = world.split(node.rank() == 0 ? 0 : 1, world.rank());
+    int n_nodes   = mpi_all_reduce(int(node.rank() == 0), world);
+    hierarchical_ = (n_nodes > 1 && n_nodes < world.size());
+  }
+
+  rank_reduction::~rank_reduction() {
+    for (auto c : {node.get(), leaders.get()}) MPI_Comm_free(&c);
+  }
+
+} // namespace triqs_cthyb
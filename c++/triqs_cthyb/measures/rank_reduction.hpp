@@ -0,0 +1,196 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "../types.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Reduction of the results over the MPI ranks
+
+   The accumulators are first summed over the ranks of each node, which
+   communicate through shared memory, into the first rank of the node. These
+   partial sums are then summed over the first ranks of the nodes. When the
+   results are only needed on rank 0 (all_ranks = false), both steps are
+   reductions to a root and the results on the other ranks are undefined.
+   Otherwise they are broadcast back, first over the nodes, then within each node.
+
+   On a single node, or with one rank per node, this is a plain reduction
+   over the communicator.
+
+   The blocks of the two-particle containers (block2_gf) are reduced in place,
+   in slices of chunk_size elements, to avoid the full temporary copy of the
+   generic MPI reduction. With async = true, the non-blocking reductions of all
+   blocks are started at once and each block can be post-processed as soon as
+   its own reduction is complete, while the next ones proceed (see
+   rank_reduce_blocks).
+   ********************************************/
+
+  class rank_reduction {
+
+    public:
+    /// Split c into the ranks of each node and the first ranks of the nodes (collective)
+    rank_reduction(triqs::mpi::communicator const &c, bool all_ranks = true, bool async = false);
+    ~rank_reduction();
+
+    rank_reduction(rank_reduction const &) = delete;
+    rank_reduction &operator=(rank_reduction const &) = delete;
+
+    bool all_ranks() const { return all_ranks_; }
+    bool hierarchical() const { return hierarchical_; }
+    bool async() const { return async_; }
+
+    /// Number of elements reduced at once in the in place reductions
+    static constexpr long chunk_size = 1 << 20;
+
+    /// In place sum of x over all ranks
+    template <typename T> void reduce(T &x) const {
+      if constexpr (is_block2_gf<T>::value) {
+        for (int i = 0; i < x.size1(); ++i)
+          for (int j = 0; j < x.size2(); ++j) reduce_data(x(i, j).data());
+      } else if (!hierarchical_) {
+        if (all_ranks_)
+          x = mpi_all_reduce(x, world);
+        else
+          x = mpi_reduce(x, world, 0);
+      } else {
+        x = mpi_reduce(x, node, 0);
+        if (node.rank() == 0) {
+          if (all_ranks_)
+            x = mpi_all_reduce(x, leaders);
+          else
+            x = mpi_reduce(x, leaders, 0);
+        }
+        if (all_ranks_) mpi_broadcast(x, node, 0);
+      }
+    }
+
+    template <typename T, typename = void> struct is_block2_gf : std::false_type {};
+    template <typename T> struct is_block2_gf<T, std::void_t<decltype(std::declval<T &>().size1())>> : std::true_type {};
+
+    /// In place sum of the contiguous array a over the ranks of c, to root or to all ranks, in slices of chunk_size elements.
+    /// If requests is given, the reductions are only started and their requests appended to it.
+    template <typename A>
+    static void chunked_reduce(A &&a, triqs::mpi::communicator const &c, bool all, int root = 0, std::vector<MPI_Request> *requests = nullptr) {
+      auto *p     = a.data_start();
+      long n      = a.domain().number_of_elements();
+      auto type   = mpi_type<std::decay_t<decltype(*p)>>();
+      MPI_Comm cm = c.get();
+      for (long start = 0; start < n; start += chunk_size) {
+        int count  = std::min(chunk_size, n - start);
+        auto *send = (all || c.rank() == root ? MPI_IN_PLACE : p + start);
+        auto *recv = (all || c.rank() == root ? p + start : nullptr);
+        if (requests) {
+          auto &r = requests->emplace_back();
+          if (all)
+            MPI_Iallreduce(send, recv, count, type, MPI_SUM, cm, &r);
+          else
+            MPI_Ireduce(send, recv, count, type, MPI_SUM, root, cm, &r);
+        } else if (all)
+          MPI_Allreduce(send, recv, count, type, MPI_SUM, cm);
+        else
+          MPI_Reduce(send, recv, count, type, MPI_SUM, root, cm);
+      }
+    }
+
+    /// Broadcast of the contiguous array a from root, in slices of chunk_size elements
+    template <typename A> static void chunked_broadcast(A &&a, triqs::mpi::communicator const &c, int root = 0) {
+      auto *p = a.data_start();
+      long n  = a.domain().number_of_elements();
+      for (long start = 0; start < n; start += chunk_size)
+        MPI_Bcast(p + start, std::min(chunk_size, n - start), mpi_type<std::decay_t<decltype(*p)>>(), root, c.get());
+    }
+
+    /// Start the non-blocking reduction of the contiguous array a (the first step of a hierarchical reduction)
+    template <typename A> void start_reduce_data(A &&a, std::vector<MPI_Request> &requests) const {
+      if (hierarchical_)
+        chunked_reduce(a, node, false, 0, &requests);
+      else
+        chunked_reduce(a, world, all_ranks_, 0, &requests);
+    }
+
+    /// Complete the reduction of a started by start_reduce_data
+    template <typename A> void finish_reduce_data(A &&a, std::vector<MPI_Request> &requests) const {
+      MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+      requests.clear();
+      if (!hierarchical_) return;
+      if (node.rank() == 0) chunked_reduce(a, leaders, all_ranks_);
+      if (all_ranks_) chunked_broadcast(a, node);
+    }
+
+    private:
+    template <typename V> static MPI_Datatype mpi_type() {
+      if constexpr (std::is_same_v<V, double>)
+        return MPI_DOUBLE;
+      else
+        return MPI_CXX_DOUBLE_COMPLEX;
+    }
+
+    // The blocking in place reduction of the array of a block
+    template <typename A> void reduce_data(A &&a) const {
+      std::vector<MPI_Request> none;
+      if (hierarchical_)
+        chunked_reduce(a, node, false);
+      else
+        chunked_reduce(a, world, all_ranks_);
+      finish_reduce_data(a, none);
+    }
+
+    triqs::mpi::communicator world, node, leaders;
+    bool all_ranks_, async_;
+    bool hierarchical_ = false;
+  };
+
+  /// Sum x over the ranks of c, with the reduction r of the solver if not null
+  template <typename T> void rank_reduce(T &x, triqs::mpi::communicator const &c, rank_reduction const *r = nullptr) {
+    if (r)
+      r->reduce(x);
+    else if constexpr (rank_reduction::is_block2_gf<T>::value) {
+      for (int i = 0; i < x.size1(); ++i)
+        for (int j = 0; j < x.size2(); ++j) rank_reduction::chunked_reduce(x(i, j).data(), c, true);
+    } else
+      x = mpi_all_reduce(x, c);
+  }
+
+  /// Sum the block2_gf x over the ranks of c as rank_reduce and call f(i, j) on each block (i, j) once it is reduced.
+  /// With an asynchronous reduction, f runs on the first blocks while the next ones are still being reduced.
+  template <typename G, typename F> void rank_reduce_blocks(G &x, triqs::mpi::communicator const &c, rank_reduction const *r, F &&f) {
+    if (r && r->async()) {
+      std::vector<std::vector<MPI_Request>> requests(x.size1() * x.size2());
+      for (int i = 0; i < x.size1(); ++i)
+        for (int j = 0; j < x.size2(); ++j) r->start_reduce_data(x(i, j).data(), requests[i * x.size2() + j]);
+      for (int i = 0; i < x.size1(); ++i)
+        for (int j = 0; j < x.size2(); ++j) {
+          r->finish_reduce_data(x(i, j).data(), requests[i * x.size2() + j]);
+          f(i, j);
+        }
+    } else {
+      rank_reduce(x, c, r);
+      for (int i = 0; i < x.size1(); ++i)
+        for (int j = 0; j < x.size2(); ++j) f(i, j);
+    }
+  }
+
+} // namespace triqs_cthyb
@@ -22,9 +22,15 @@
 #pragma once
 
 #include "../types.hpp"
+#include "../task_pool.hpp"
+#include "./det_snapshot.hpp"
+
+#include <memory>
 
 namespace triqs_cthyb {
 
+  class rank_reduction;
+
   // --------------------------------------------------------------------------
   /// Two-particle Green's function block-measure
   /// specifying the two connected blocks
@@ -48,13 +54,41 @@ namespace triqs_cthyb {
 
     private:
     std::vector<G2_measure_t> measures;
+    std::shared_ptr<task_pool> pool; // shared by all the two-particle measurements, if measure_G2_n_threads > 1
 
     public:
     const gf_struct_t gf_struct;
     const solve_parameters_t params;
 
+    /// Reduction of the results over the MPI ranks (see rank_reduce), a plain one if null
+    rank_reduction const *ranks = nullptr;
+
+    /// Determinants read by the measures instead of those of their data, if not null (snapshots of measure_pipeline)
+    std::vector<det_snapshot> const *dets = nullptr;
+
+    /// Call f(dets) with the determinants the measures of data read
+    template <typename Data, typename F> void with_dets(Data const &data, F const &f) const {
+      if (dets)
+        f(*dets);
+      else
+        f(data.dets);
+    }
+
     const std::vector<G2_measure_t> &operator()() { return measures; }
 
+    /// Call f(i) for i in [0, n), on the threads of the pool if any. The calls must write to distinct data.
+    template <typename F> void parallel_for(int n, F const &f) {
+      if (pool)
+        pool->run(n, f);
+      else
+        for (int i = 0; i < n; ++i) f(i);
+    }
+
+    /// Call f(m) for every block-measure m, on the threads of the pool if any (each one writes to its own block of G2)
+    template <typename F> void for_each_measure(F const &f) {
+      parallel_for(measures.size(), [&](int i) { f(measures[i]); });
+    }
+
     /// the constructor mangles the parameters, especially params.measure_G2_blocks
     /// and populates the std::vector<g4_measure_t> measures
     G2_measures_t(const G_tau_t &_Delta_tau, const gf_struct_t &gf_struct, const solve_parameters_t &params) : gf_struct(gf_struct), params(params) {
@@ -100,6 +134,8 @@ namespace triqs_cthyb {
 
         measures.push_back(measure);
       }
+
+      if (params.measure_G2_n_threads > 1) pool = std::make_shared<task_pool>(params.measure_G2_n_threads);
     }
   };
 
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./rank_reduction.hpp"
+
+#include <any>
+#include <type_traits>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Reduction of the accumulators of several walkers
+
+   With several walkers (Markov chains) in a process, the results of the walkers
+   are collected one after the other with the same measures, in the same order.
+   The measures of all walkers but the last one only add their accumulators to
+   the slots of the reduction (merge). The measures of the last walker add the
+   slots to their own accumulators, which are then reduced over the MPI ranks
+   (finish), so that there is a single MPI reduction per accumulator.
+
+   The measures of all the walkers of the process are given the same reduction
+   and call reduce on each of their accumulators in collect_results. Outside of
+   merge and finish, reduce is a plain reduction over the MPI ranks.
+   ********************************************/
+
+  class walker_reduction {
+
+    public:
+    /// ranks : the reduction over the MPI ranks, a plain all-reduce if null
+    walker_reduction(rank_reduction const *ranks = nullptr) : ranks(ranks) {}
+
+    /// Add the accumulators of mc to the slots
+    template <typename MC> void merge(MC &mc, triqs::mpi::communicator const &c) { collect(mc, c, true); }
+
+    /// Reduce the accumulators of mc and the slots over the MPI ranks
+    template <typename MC> void finish(MC &mc, triqs::mpi::communicator const &c) { collect(mc, c, false); }
+
+    /// True while merging, the measures may skip the normalisation of their results
+    bool merging() const { return collecting && merging_; }
+
+    /// Sum x with the corresponding accumulators of the other walkers and over the MPI ranks (see rank_reduce)
+    template <typename T> void reduce(T &x, triqs::mpi::communicator const &c) {
+      if (!collecting) {
+        rank_reduce(x, c, ranks);
+        return;
+      }
+      using regular_t = typename regular_type_of<T>::type;
+      int n           = n_calls++;
+      if (n > slots.size()) TRIQS_RUNTIME_ERROR << "The walkers do not have the same measures";
+      if (merging_) {
+        if (n == slots.size())
+          slots.emplace_back(regular_t(x));
+        else
+          add_to(std::any_cast<regular_t &>(slots[n]), x);
+      } else {
+        if (n < slots.size()) add_to(x, std::any_cast<regular_t const &>(slots[n]));
+        rank_reduce(x, c, ranks);
+      }
+    }
+
+    private:
+    template <typename T> struct is_vector : std::false_type {};
+    template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
+
+    template <typename A, typename B> static void add_to(A &a, B const &b) {
+      if constexpr (is_block_gf_or_view<A>::value) {
+        for (int i = 0; i < a.size(); ++i) a[i].data() += b[i].data();
+      } else if constexpr (std::is_same_v<A, histogram>) {
+        a = a + b;
+      } else if constexpr (is_vector<A>::value) {
+        for (int i = 0; i < a.size(); ++i) add_to(a[i], b[i]);
+      } else
+        a += b;
+    }
+
+    template <typename MC> void collect(MC &mc, triqs::mpi::communicator const &c, bool merge) {
+      merging_   = merge;
+      n_calls    = 0;
+      collecting = true;
+      try {
+        mc.collect_results(c);
+      } catch (...) {
+        collecting = false;
+        throw;
+      }
+      collecting = false;
+    }
+
+    rank_reduction const *ranks;
+    std::vector<std::any> slots;
+    bool collecting = false;
+    bool merging_   = false;
+    int n_calls     = 0;
+  };
+
+} // namespace triqs_cthyb
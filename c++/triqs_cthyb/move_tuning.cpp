@@ -0,0 +1,137 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./move_tuning.hpp"
+
+#include <algorithm>
+
+namespace triqs_cthyb {
+
+  namespace {
+    // Accepted moves per second of a set of moves
+    struct acceptance_rate {
+      long n_attempted = 0, n_accepted = 0;
+      double time = 0;
+      void add(move_stats const &s) {
+        n_attempted += s.n_attempted;
+        n_accepted += s.n_accepted;
+        time += s.time;
+      }
+      bool tried() const { return n_attempted > 0; }
+      double operator()() const { return (time > 0 ? n_accepted / time : 0); }
+    };
+  } // namespace
+
+  void mpi_sum_move_stats(move_stats_map_t &stats, triqs::mpi::communicator const &c) {
+    for (auto &kv : stats) {
+      auto &s       = kv.second;
+      s.n_attempted = mpi_all_reduce(s.n_attempted, c);
+      s.n_accepted  = mpi_all_reduce(s.n_accepted, c);
+      s.time        = mpi_all_reduce(s.time, c);
+    }
+  }
+
+  // ------------------------------------------------------------------
+
+  move_weights_t tune_move_weights(move_stats_map_t const &stats, move_weights_t const &tried, std::vector<std::string> const &block_names,
+                                   double min_weight) {
+
+    int n_blocks = block_names.size();
+    auto get = [&stats](std::string const &key) {
+      auto it = stats.find(key);
+      return (it == stats.end() ? move_stats{} : it->second);
+    };
+
+    // Plain pairs, for each block and altogether
+    acceptance_rate pair;
+    std::vector<acceptance_rate> block(n_blocks);
+    for (int b = 0; b < n_blocks; ++b)
+      for (auto kind : {"Insert", "Remove"}) {
+        block[b].add(get(move_stats_key(kind, block_names[b])));
+        pair.add(get(move_stats_key(kind, block_names[b])));
+      }
+
+    // Best window length
+    acceptance_rate window;
+    int best_window = -1;
+    for (int k = 0; k < tried.window_lengths.size(); ++k) {
+      acceptance_rate r;
+      for (int b = 0; b < n_blocks; ++b)
+        for (auto kind : {"Insert", "Remove"}) r.add(get(move_stats_key(kind, block_names[b], tried.window_lengths[k])));
+      if (best_window < 0 || r() > window()) {
+        best_window = k;
+        window      = r;
+      }
+    }
+
+    acceptance_rate importance;
+    for (int b = 0; b < n_blocks; ++b)
+      for (auto kind : {"Insert", "Remove"}) importance.add(get(move_stats_key(kind, block_names[b], "importance")));
+
+    acceptance_rate double_pair, shift, global;
+    double_pair.add(get("Insert four operators"));
+    double_pair.add(get("Remove four operators"));
+    shift.add(get("Shift one operator"));
+    global.add(get("Global moves"));
+
+    // Weights relative to the most efficient kind of move among those tried
+    move_weights_t w = tried;
+    std::vector<std::pair<double *, acceptance_rate const *>> kinds{
+       {&w.pair, &pair},   {&w.window, &window}, {&w.double_pair, &double_pair},
+       {&w.shift, &shift}, {&w.global, &global}, {&w.importance, &importance}};
+    double max_rate = 0;
+    for (auto const &k : kinds)
+      if (k.second->tried()) max_rate = std::max(max_rate, (*k.second)());
+    if (max_rate > 0)
+      for (auto const &k : kinds)
+        if (k.second->tried()) *k.first = std::max(min_weight, (*k.second)() / max_rate);
+
+    double max_block_rate = 0;
+    for (auto const &r : block) max_block_rate = std::max(max_block_rate, r());
+    if (max_block_rate > 0)
+      for (int b = 0; b < n_blocks; ++b) w.block[b] = std::max(min_weight, block[b]() / max_block_rate);
+
+    if (best_window >= 0) w.window_lengths = {tried.window_lengths[best_window]};
+    return w;
+  }
+
+  // ------------------------------------------------------------------
+
+  std::map<std::string, double> report_move_weights(move_weights_t const &w, std::vector<std::string> const &block_names) {
+    std::map<std::string, double> r{{"pair", w.pair}, {"double_pair", w.double_pair}, {"shift", w.shift}, {"global", w.global},
+                                   {"importance", w.importance}};
+    if (!w.window_lengths.empty()) {
+      r["window"]        = w.window;
+      r["window_length"] = w.window_lengths[0];
+    }
+    for (int b = 0; b < block_names.size(); ++b) r["block_" + block_names[b]] = w.block[b];
+    return r;
+  }
+
+  // ------------------------------------------------------------------
+
+  std::map<std::string, std::vector<double>> move_timing_table(move_stats_map_t const &stats) {
+    std::map<std::string, std::vector<double>> r;
+    for (auto const &[name, s] : stats)
+      r[name] = {double(s.n_attempted), double(s.n_accepted), s.time, (s.n_attempted > 0 ? s.time / s.n_attempted : 0.0)};
+    return r;
+  }
+
+} // namespace triqs_cthyb
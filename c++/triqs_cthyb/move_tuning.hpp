@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./moves/timed.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  using move_stats_map_t = std::map<std::string, move_stats>;
+
+  /// Weights of the moves. The insertion and the removal of a kind always share the same weight.
+  struct move_weights_t {
+    double pair        = 1.0;           // Insert/remove two operators
+    double window      = 1.0;           // Insert/remove two operators within a window (all window lengths together)
+    double double_pair = 1.0;           // Insert/remove four operators
+    double shift       = 1.0;           // Shift one operator
+    double global      = 1.0;           // Global moves
+    double importance  = 1.0;           // Insert/remove two operators with importance sampled proposals
+    std::vector<double> window_lengths; // Window lengths of the windowed moves (none: no windowed moves)
+    std::vector<double> block;          // Proposal probability of each block
+  };
+
+  // Keys of the statistics of the moves, also their names in the timing table
+  inline std::string move_stats_key(std::string const &kind, std::string const &block_name) { return kind + " Delta_" + block_name; }
+  inline std::string move_stats_key(std::string const &kind, std::string const &block_name, double window_length) {
+    return kind + " Delta_" + block_name + " (window " + std::to_string(window_length) + ")";
+  }
+  inline std::string move_stats_key(std::string const &kind, std::string const &block_name, std::string const &variant) {
+    return kind + " Delta_" + block_name + " (" + variant + ")";
+  }
+
+  /// Sum the statistics over all ranks (the keys must be the same on all ranks)
+  void mpi_sum_move_stats(move_stats_map_t &stats, triqs::mpi::communicator const &c);
+
+  /**
+   * Weights maximizing the number of accepted moves per second
+   *
+   * Every kind of move (and every block) gets a weight proportional to its accepted moves per second,
+   * but not less than min_weight times the largest one, to keep the Markov chain ergodic.
+   * Only the best window length is kept for the windowed moves.
+   * The statistics must have been summed over the ranks, so that all ranks choose the same weights.
+   */
+  move_weights_t tune_move_weights(move_stats_map_t const &stats, move_weights_t const &tried, std::vector<std::string> const &block_names,
+                                   double min_weight = 0.05);
+
+  /// Summary of tuned weights, for the results
+  std::map<std::string, double> report_move_weights(move_weights_t const &w, std::vector<std::string> const &block_names);
+
+  /// Timing table : for each move, the number of attempts, of acceptances, the time spent and the time per attempt (in seconds)
+  std::map<std::string, std::vector<double>> move_timing_table(move_stats_map_t const &stats);
+
+} // namespace triqs_cthyb
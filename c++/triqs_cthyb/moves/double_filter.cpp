@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./double_filter.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace triqs_cthyb {
+
+  double_move_filter::double_move_filter(qmc_data const &data, int block_index1, int block_index2)
+     : block_size1(data.n_inner[block_index1]), block_size2(data.n_inner[block_index2]) {
+
+    auto const &h_diag = data.h_diag;
+    int n_subspaces    = h_diag.n_subspaces();
+    auto lin           = [&data](int b, int inner) { return data.linindex.at({b, inner}); };
+
+    // Image of the subspace s by an operator (-1 : no image)
+    struct op_t {
+      int linear_index;
+      bool dagger;
+    };
+    auto connection = [&h_diag](op_t const &op, int s) {
+      return (op.dagger ? h_diag.cdag_connection(op.linear_index, s) : h_diag.c_connection(op.linear_index, s));
+    };
+
+    // Can the operators, in some order, map a subspace to itself?
+    auto closed_sequence = [&](std::array<op_t, 4> const &ops) {
+      std::array<int, 4> order{0, 1, 2, 3};
+      do {
+        for (int s0 = 0; s0 < n_subspaces; ++s0) {
+          int s = s0;
+          for (int n = 0; n < 4 && s != -1; ++n) s = connection(ops[order[n]], s);
+          if (s == s0) return true;
+        }
+      } while (std::next_permutation(order.begin(), order.end()));
+      return false;
+    };
+
+    kept.resize(block_size1 * block_size1 * block_size2 * block_size2);
+    for (int i = 0; i < block_size1; ++i)
+      for (int j = 0; j < block_size1; ++j)
+        for (int k = 0; k < block_size2; ++k)
+          for (int l = 0; l < block_size2; ++l) {
+            std::array<op_t, 4> ops{op_t{lin(block_index1, i), true}, op_t{lin(block_index1, j), false}, op_t{lin(block_index2, k), true},
+                                    op_t{lin(block_index2, l), false}};
+            bool a = closed_sequence(ops);
+            kept[((i * block_size1 + j) * block_size2 + k) * block_size2 + l] = a;
+            any_kept |= a;
+          }
+  }
+}
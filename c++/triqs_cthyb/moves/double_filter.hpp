@@ -0,0 +1,55 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "../qmc_data.hpp"
+
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /**
+   * Restriction of the proposal space of the insertion/removal of four operators C^dagger_{A i} C_{A j} C^dagger_{B k} C_{B l}
+   *
+   * A quadruple (i, j, k, l) is kept if, in some order, the four operators map an atomic subspace back
+   * to itself, i.e. if they can be inserted together in an empty stretch of a configuration.
+   * This is computed once from the connection tables of atom_diag.
+   *
+   * The other quadruples are not forbidden : inserted among existing operators, e.g. (i, j, i, j) next to
+   * operators which change the subspace, they may give a non-zero weight. They are only pruned from the
+   * proposals of this move, and such configurations are still reached by the other moves. Since both the
+   * insertion and the removal propose exactly the kept quadruples, detailed balance holds.
+   */
+  class double_move_filter {
+
+    int block_size1, block_size2;
+    std::vector<char> kept; // Index ((i * block_size1 + j) * block_size2 + k) * block_size2 + l
+    bool any_kept = false;
+
+    public:
+    double_move_filter(qmc_data const &data, int block_index1, int block_index2);
+
+    /// Is any quadruple kept? If not, the move is useless.
+    bool any() const { return any_kept; }
+
+    /// Is the quadruple in the proposal space?
+    bool operator()(int i, int j, int k, int l) const { return kept[((i * block_size1 + j) * block_size2 + k) * block_size2 + l]; }
+  };
+}
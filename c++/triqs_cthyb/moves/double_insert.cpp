@@ -31,7 +31,8 @@ namespace triqs_cthyb {
 
   move_insert_c_c_cdag_cdag::move_insert_c_c_cdag_cdag(int block_index1, int block_index2, int block_size1, int block_size2,
                                                        std::string const &block_name1, std::string const &block_name2, qmc_data &data,
-                                                       mc_tools::random_generator &rng, histo_map_t *histos)
+                                                       mc_tools::random_generator &rng, histo_map_t *histos,
+                                                       std::shared_ptr<double_move_filter const> filter)
      : data(data),
        config(data.config),
        rng(rng),
@@ -42,7 +43,8 @@ namespace triqs_cthyb {
        histo_proposed1(add_histo("double_insert_length_proposed_" + block_name1, histos)),
        histo_proposed2(add_histo("double_insert_length_proposed_" + block_name2, histos)),
        histo_accepted1(add_histo("double_insert_length_accepted_" + block_name1, histos)),
-       histo_accepted2(add_histo("double_insert_length_accepted_" + block_name2, histos)) {}
+       histo_accepted2(add_histo("double_insert_length_accepted_" + block_name2, histos)),
+       filter(std::move(filter)) {}
 
   mc_weight_t move_insert_c_c_cdag_cdag::attempt() {
 
@@ -58,6 +60,7 @@ namespace triqs_cthyb {
     op2 = op_desc{block_index1, rs2, false, data.linindex[std::make_pair(block_index1, rs2)]};
     op3 = op_desc{block_index2, rs3, true, data.linindex[std::make_pair(block_index2, rs3)]};
     op4 = op_desc{block_index2, rs4, false, data.linindex[std::make_pair(block_index2, rs4)]};
+    if (filter && !(*filter)(rs1, rs2, rs3, rs4)) return 0; // pruned from the proposal space
 
     // Choice of times for insertion. Find the time as double and them put them on the grid.
     tau1 = data.tau_seg.get_random_pt(rng);
@@ -31,7 +31,8 @@ namespace triqs_cthyb {
 
   move_remove_c_c_cdag_cdag::move_remove_c_c_cdag_cdag(int block_index1, int block_index2, int block_size1, int block_size2,
                                                        std::string const &block_name1, std::string const &block_name2, qmc_data &data,
-                                                       mc_tools::random_generator &rng, histo_map_t *histos)
+                                                       mc_tools::random_generator &rng, histo_map_t *histos,
+                                                       std::shared_ptr<double_move_filter const> filter)
      : data(data),
        config(data.config),
        rng(rng),
@@ -42,7 +43,8 @@ namespace triqs_cthyb {
        histo_proposed1(add_histo("double_remove_length_proposed_" + block_name1, histos)),
        histo_proposed2(add_histo("double_remove_length_proposed_" + block_name2, histos)),
        histo_accepted1(add_histo("double_remove_length_accepted_" + block_name1, histos)),
-       histo_accepted2(add_histo("double_remove_length_accepted_" + block_name2, histos)) {}
+       histo_accepted2(add_histo("double_remove_length_accepted_" + block_name2, histos)),
+       filter(std::move(filter)) {}
 
   mc_weight_t move_remove_c_c_cdag_cdag::attempt() {
 
@@ -68,6 +70,8 @@ namespace triqs_cthyb {
     int num_c_dag1 = rng(det1_size), num_c1 = rng(det1_size);
     int num_c_dag2 = rng(det2_size), num_c2 = rng(det2_size);
     if ((block_index1 == block_index2) && ((num_c_dag1 == num_c_dag2) || (num_c1 == num_c2))) return 0; // picked the same operator twice
+    if (filter && !(*filter)(det1.get_x(num_c_dag1).second, det1.get_y(num_c1).second, det2.get_x(num_c_dag2).second, det2.get_y(num_c2).second))
+      return 0; // pruned from the proposal space, as the reverse insertion
 
 #ifdef EXT_DEBUG
     std::cerr << "* Proposing to remove: ";
@@ -22,6 +22,9 @@
 #include <triqs/mc_tools.hpp>
 #include <algorithm>
 #include "../qmc_data.hpp"
+#include "./double_filter.hpp"
+
+#include <memory>
 
 namespace triqs_cthyb {
 
@@ -37,13 +40,15 @@ namespace triqs_cthyb {
     histogram *histo_accepted1, *histo_accepted2;
     double dtau1, dtau2;
     h_scalar_t new_atomic_weight, new_atomic_reweighting;
+    std::shared_ptr<double_move_filter const> filter; // Allowed quadruples of inner indices (none: all)
     time_pt tau1, tau2, tau3, tau4;
 
     histogram *add_histo(std::string const &name, histo_map_t *histos);
 
     public:
     move_remove_c_c_cdag_cdag(int block_index1, int block_index2, int block_size1, int block_size2, std::string const &block_name1,
-                              std::string const &block_name2, qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos);
+                              std::string const &block_name2, qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos,
+                              std::shared_ptr<double_move_filter const> filter = {});
 
     mc_weight_t attempt();
     mc_weight_t accept();
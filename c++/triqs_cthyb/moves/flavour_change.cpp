@@ -0,0 +1,122 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./flavour_change.hpp"
+
+namespace triqs_cthyb {
+
+  move_change_flavour_pair::move_change_flavour_pair(int block_index, int block_size, qmc_data &data, mc_tools::random_generator &rng)
+     : data(data), config(data.config), rng(rng), block_index(block_index), block_size(block_size) {}
+
+  mc_weight_t move_change_flavour_pair::attempt() {
+
+#ifdef EXT_DEBUG
+    std::cerr << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>" << std::endl;
+    std::cerr << "In config " << config.get_id() << std::endl;
+    std::cerr << "* Attempt for move_change_flavour_pair (block " << block_index << ")" << std::endl;
+#endif
+
+    updated_ops.clear();
+    auto &det    = data.dets[block_index];
+    int det_size = det.size();
+    if (det_size == 0) return 0; // nothing to change
+
+    // Pick up a C^dagger and a C at random, and their new inner indices
+    int num_c_dag = rng(det_size), num_c = rng(det_size);
+    auto x = det.get_x(num_c_dag), y = det.get_y(num_c);
+    int inner1 = rng(block_size), inner2 = rng(block_size);
+    if (inner1 == x.second && inner2 == y.second) return 0; // nothing changes
+    updated_ops.emplace(x.first, op_desc{block_index, inner1, true, data.linindex[std::make_pair(block_index, inner1)]});
+    updated_ops.emplace(y.first, op_desc{block_index, inner2, false, data.linindex[std::make_pair(block_index, inner2)]});
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Proposing to change:" << std::endl;
+    for (auto const &o : updated_ops) std::cerr << "tau = " << o.first << " to " << o.second << std::endl;
+#endif
+
+    // --- Compute the det ratio : one row and one column change, at the same positions
+    auto det_ratio = det.try_change_col_row(num_c_dag, num_c, {x.first, inner1}, {y.first, inner2});
+
+    // for quick abandon
+    double random_number = rng.preview();
+    if (random_number == 0.0) return 0;
+    double p_yee = std::abs(det_ratio / data.atomic_weight);
+
+    // --- Compute the atomic_weight ratio
+    data.imp_trace.try_replace(updated_ops);
+    std::tie(new_atomic_weight, new_atomic_reweighting) = data.imp_trace.compute(p_yee, random_number);
+    if (new_atomic_weight == 0.0) {
+#ifdef EXT_DEBUG
+      std::cerr << "atomic_weight == 0" << std::endl;
+#endif
+      return 0;
+    }
+    auto atomic_weight_ratio = new_atomic_weight / data.atomic_weight;
+    if (!isfinite(atomic_weight_ratio))
+      TRIQS_RUNTIME_ERROR << "atomic_weight_ratio not finite " << new_atomic_weight << " " << data.atomic_weight << " "
+                          << new_atomic_weight / data.atomic_weight << " in config " << config.get_id();
+
+    // --- Compute the weight
+    mc_weight_t p = atomic_weight_ratio * det_ratio;
+
+#ifdef EXT_DEBUG
+    std::cerr << "Trace ratio: " << atomic_weight_ratio << '\t';
+    std::cerr << "Det ratio: " << det_ratio << '\t';
+    std::cerr << "Weight: " << p << std::endl;
+#endif
+
+    return p;
+  }
+
+  mc_weight_t move_change_flavour_pair::accept() {
+
+    for (auto const &o : updated_ops) config.replace(o.first, o.second);
+    config.finalize();
+
+    data.dets[block_index].complete_operation();
+    data.update_sign();
+    data.atomic_weight      = new_atomic_weight;
+    data.atomic_reweighting = new_atomic_reweighting;
+
+    data.imp_trace.confirm_replace();
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_change_flavour_pair accepted" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+    check_det_sequence(data.dets[block_index], config.get_id());
+#endif
+
+    return data.current_sign / data.old_sign;
+  }
+
+  void move_change_flavour_pair::reject() {
+
+    config.finalize();
+    data.imp_trace.cancel_replace();
+    data.dets[block_index].reject_last_try();
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_change_flavour_pair rejected" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+    check_det_sequence(data.dets[block_index], config.get_id());
+#endif
+  }
+}
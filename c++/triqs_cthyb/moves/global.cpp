@@ -23,16 +23,33 @@
 
 namespace triqs_cthyb {
 
-  move_global::move_global(std::string const &name, indices_map_t const &substitution_map, qmc_data &data, mc_tools::random_generator &rng)
+  move_global::move_global(std::string const &name, indices_map_t const &substitution_map, qmc_data &data, mc_tools::random_generator &rng,
+                           int max_woodbury_rank)
      : name(name),
        data(data),
        config(data.config),
        rng(rng),
        substitute_c(data.linindex.size()),
        substitute_c_dag(data.linindex.size()),
+       max_woodbury_rank(max_woodbury_rank),
        x(data.dets.size()),
        y(data.dets.size()) {
 
+    int n_blocks = data.dets.size();
+    lin_index.resize(n_blocks);
+    for (auto const &l : data.linindex) {
+      auto &v = lin_index[l.first.first];
+      if (v.size() <= l.first.second) v.resize(l.first.second + 1);
+      v[l.first.second] = l.second;
+    }
+    x_changed.resize(n_blocks);
+    y_changed.resize(n_blocks);
+    n_changed_x.resize(n_blocks);
+    n_changed_y.resize(n_blocks);
+    changed_x.resize(n_blocks);
+    changed_y.resize(n_blocks);
+    block_moved.resize(n_blocks);
+
     auto const &fops = data.h_diag.get_fops();
 
     // Inverse of data.linindex
@@ -40,6 +57,7 @@ namespace triqs_cthyb {
     for (auto const &l : data.linindex) lin_to_block_inner[l.second] = l.first;
 
     bool identity = true;
+    std::set<int> sources;
     for (int lin = 0; lin < lin_to_block_inner.size(); ++lin) {
       int new_lin, new_block, new_inner;
 
@@ -55,15 +73,139 @@ namespace triqs_cthyb {
         identity = false;
         affected_blocks.insert(lin_to_block_inner[lin].first);
         affected_blocks.insert(new_block);
+        sources.insert(lin_to_block_inner[lin].first);
       }
 
       substitute_c[lin]     = op_desc{new_block, new_inner, false, new_lin};
       substitute_c_dag[lin] = op_desc{new_block, new_inner, true, new_lin};
     }
 
+    source_blocks.assign(sources.begin(), sources.end());
+
     if (identity) std::cerr << "WARNING: global move '" << name << "' changes no operator indices, therefore is useless." << std::endl;
   }
 
+  // Same random choices as erasing, one after the other, a random element of the list of candidates,
+  // but the k-th remaining candidate is found in O(log n) with a Fenwick tree.
+  void move_global::select_candidates() {
+
+    int n = candidates.size();
+    selected.assign(n, 1);
+    tree.assign(n + 1, 0);
+    for (int i = 1; i <= n; ++i) {
+      tree[i] += 1;
+      if (int j = i + (i & -i); j <= n) tree[j] += tree[i];
+    }
+    int top = 1;
+    while (2 * top <= n) top *= 2;
+
+    int n_no_update = rng(n);
+    for (int r = 0; r < n_no_update; ++r) {
+      int k = rng(n - r), pos = 0; // find the k-th selected candidate
+      for (int step = top; step > 0; step /= 2)
+        if (pos + step <= n && tree[pos + step] <= k) {
+          pos += step;
+          k -= tree[pos];
+        }
+      selected[pos] = 0;
+      for (int i = pos + 1; i <= n; i += i & -i) --tree[i];
+    }
+  }
+
+  bool move_global::prepare_woodbury(int block_index) {
+
+    auto const &det = data.dets[block_index];
+    rows_out.clear();
+    cols_out.clear();
+    rows_in.clear();
+    cols_in.clear();
+    for (int i = 0; i < det.size(); ++i) {
+      if (x_changed[block_index][i]) rows_out.push_back(i);
+      if (y_changed[block_index][i]) cols_out.push_back(i);
+    }
+    for (int i = 0; i < candidates.size(); ++i) {
+      auto const &c = candidates[i];
+      if (selected[i] && c.new_op.block_index == block_index) (c.new_op.dagger ? rows_in : cols_in).emplace_back(c.tau, c.new_op.inner_index);
+    }
+
+    // The det must keep its size, and the update must be cheaper than a refill
+    int rank = rows_out.size() + cols_out.size();
+    return rows_out.size() == rows_in.size() && cols_out.size() == cols_in.size() && rank <= max_woodbury_rank && rank < det.size();
+  }
+
+  // Replacing the rows R and the columns C of the det matrix M in place gives M'' = M + U V with
+  // U = (E_R, B) and V = (A ; E_C^T), where A holds the changes of the rows R (with the new columns)
+  // and B the changes of the columns C outside of R. Hence det M'' / det M = det(1 + V M^-1 U),
+  // a determinant of size |R| + |C|. M'' is the new matrix up to the reordering of its rows and
+  // columns by decreasing time. This costs O(|R| n^2 + |C| n^2) instead of the O(n^3) of a refill.
+  mc_weight_t move_global::woodbury_ratio(int block_index) {
+
+    auto const &det = data.dets[block_index];
+    auto const &f   = det.get_function();
+    int n = det.size(), kr = rows_out.size(), kc = cols_out.size();
+
+    // Arguments of M'' : rows and columns replaced in place
+    std::vector<std::pair<time_pt, int>> xs(n), ys(n);
+    std::vector<char> in_rows_out(n, 0);
+    for (int i = 0; i < n; ++i) {
+      xs[i] = det.get_x(i);
+      ys[i] = det.get_y(i);
+    }
+    for (int a = 0; a < kr; ++a) {
+      xs[rows_out[a]]          = rows_in[a];
+      in_rows_out[rows_out[a]] = 1;
+    }
+    for (int b = 0; b < kc; ++b) ys[cols_out[b]] = cols_in[b];
+
+    auto m_inv = det.inverse_matrix();
+    matrix<det_scalar_t> s(kr + kc, kr + kc);
+    s() = 0;
+    for (int a = 0; a < kr + kc; ++a) s(a, a) = 1;
+
+    matrix<det_scalar_t> w;
+    if (kc > 0) {
+      matrix<det_scalar_t> bm(n, kc);
+      for (int i = 0; i < n; ++i)
+        for (int b = 0; b < kc; ++b)
+          bm(i, b) = in_rows_out[i] ? det_scalar_t(0) : f(det.get_x(i), ys[cols_out[b]]) - f(det.get_x(i), det.get_y(cols_out[b]));
+      w = m_inv * bm;
+      for (int b = 0; b < kc; ++b) {
+        for (int a = 0; a < kr; ++a) s(kr + b, a) = m_inv(cols_out[b], rows_out[a]);
+        for (int b2 = 0; b2 < kc; ++b2) s(kr + b, kr + b2) += w(cols_out[b], b2);
+      }
+    }
+    if (kr > 0) {
+      matrix<det_scalar_t> am(kr, n);
+      for (int a = 0; a < kr; ++a)
+        for (int j = 0; j < n; ++j) am(a, j) = f(xs[rows_out[a]], ys[j]) - f(det.get_x(rows_out[a]), det.get_y(j));
+      matrix<det_scalar_t> am_inv = am * m_inv;
+      for (int a = 0; a < kr; ++a)
+        for (int a2 = 0; a2 < kr; ++a2) s(a, a2) += am_inv(a, rows_out[a2]);
+      if (kc > 0) {
+        matrix<det_scalar_t> aw = am * w;
+        for (int a = 0; a < kr; ++a)
+          for (int b = 0; b < kc; ++b) s(a, kr + b) = aw(a, b);
+      }
+    }
+
+    // Signature of the permutation sorting the arguments by decreasing time
+    auto signature = [](std::vector<std::pair<time_pt, int>> const &v) {
+      std::vector<int> p(v.size());
+      std::iota(p.begin(), p.end(), 0);
+      std::sort(p.begin(), p.end(), [&v](int i, int j) { return v[i].first > v[j].first; });
+      std::vector<char> seen(v.size(), 0);
+      int sign = 1;
+      for (int i = 0; i < p.size(); ++i) {
+        int len = 0;
+        for (int j = i; !seen[j]; j = p[j], ++len) seen[j] = 1;
+        if (len > 0 && len % 2 == 0) sign = -sign;
+      }
+      return sign;
+    };
+
+    return determinant(s) * double(signature(xs) * signature(ys));
+  }
+
   mc_weight_t move_global::attempt() {
 
 #ifdef EXT_DEBUG
@@ -72,58 +214,119 @@ namespace triqs_cthyb {
     std::cerr << "* Attempt for move move_global (" << name << ")" << std::endl;
 #endif
 
-    updated_ops.clear();
-    for (auto const &o : data.config) {
-      auto const &tau    = o.first;
-      auto const &old_op = o.second;
-      auto const &new_op = (old_op.dagger ? substitute_c_dag : substitute_c)[old_op.linear_index];
-      if (old_op.linear_index != new_op.linear_index) updated_ops.emplace(tau, new_op);
+    // No pending det tries yet : reject() must not see those of a previous attempt which returned early
+    tried_blocks.clear();
+    woodbury_blocks.clear();
+
+    // Operators which can be substituted, read from the determinants of the blocks holding them
+    candidates.clear();
+    for (int b : source_blocks) {
+      auto const &det = data.dets[b];
+      for (int i = 0; i < det.size(); ++i) {
+        auto const &xi     = det.get_x(i);
+        auto const &new_op = substitute_c_dag[lin_index[b][xi.second]];
+        if (new_op.linear_index != lin_index[b][xi.second]) candidates.push_back({xi.first, new_op, b, i});
+      }
+      for (int j = 0; j < det.size(); ++j) {
+        auto const &yj     = det.get_y(j);
+        auto const &new_op = substitute_c[lin_index[b][yj.second]];
+        if (new_op.linear_index != lin_index[b][yj.second]) candidates.push_back({yj.first, new_op, b, j});
+      }
     }
 
 #ifdef EXT_DEBUG
-    std::cerr << updated_ops.size() << " out of " << data.config.size() << " operators can be changed" << std::endl;
+    std::cerr << candidates.size() << " out of " << data.config.size() << " operators can be changed" << std::endl;
 #endif
 
     // No operators can be updated...
-    if (!updated_ops.size()) return 0;
+    if (candidates.empty()) return 0;
+
+    // In the order of the configuration
+    std::sort(candidates.begin(), candidates.end(), [](candidate_t const &c1, candidate_t const &c2) { return c1.tau > c2.tau; });
 
     // Choose a random number of operators, which will not actually be updated
     // (we always update at least one operator)
-    int n_no_update = rng(updated_ops.size());
-    // Remove some operators
-    for (int i = 0; i < n_no_update; ++i) {
-      auto it = std::begin(updated_ops);
-      std::advance(it, rng(updated_ops.size()));
-      updated_ops.erase(it);
-    }
+    select_candidates();
+
+    updated_ops.clear();
+    for (int i = 0; i < candidates.size(); ++i)
+      if (selected[i]) updated_ops.emplace_hint(updated_ops.end(), candidates[i].tau, candidates[i].new_op);
 
 #ifdef EXT_DEBUG
     std::cerr << updated_ops.size() << " operators will actually be changed" << std::endl;
 #endif
 
-    // Derive new arguments of the dets
+    // Rows and columns of the dets which change
+    for (auto block_index : affected_blocks) {
+      x_changed[block_index].assign(data.dets[block_index].size(), 0);
+      y_changed[block_index].assign(data.dets[block_index].size(), 0);
+      n_changed_x[block_index] = n_changed_y[block_index] = 0;
+      block_moved[block_index]                            = 0;
+    }
+    for (int i = 0; i < candidates.size(); ++i) {
+      if (!selected[i]) continue;
+      auto const &c = candidates[i];
+      int new_block = c.new_op.block_index;
+      (c.new_op.dagger ? x_changed : y_changed)[c.old_block][c.det_pos] = 1;
+      if (new_block != c.old_block)
+        block_moved[c.old_block] = block_moved[new_block] = 1;
+      else if (c.new_op.dagger) {
+        ++n_changed_x[new_block];
+        changed_x[new_block] = &c;
+      } else {
+        ++n_changed_y[new_block];
+        changed_y[new_block] = &c;
+      }
+    }
+
+    // Derive new arguments of the dets to be refilled : the blocks which operators leave or enter,
+    // and those with more than one row or column changed. The others get a single row/column update.
+    auto needs_refill = [this](int b) { return block_moved[b] || n_changed_x[b] > 1 || n_changed_y[b] > 1; };
     for (auto block_index : affected_blocks) {
+      if (!needs_refill(block_index)) continue;
+      auto const &det = data.dets[block_index];
       x[block_index].clear();
       y[block_index].clear();
+      for (int i = 0; i < det.size(); ++i)
+        if (!x_changed[block_index][i]) x[block_index].push_back(det.get_x(i));
+      for (int j = 0; j < det.size(); ++j)
+        if (!y_changed[block_index][j]) y[block_index].push_back(det.get_y(j));
     }
-
-    for (auto const &o : data.config) {
-      auto const &tau    = o.first;
-      auto it            = updated_ops.find(tau);
-      auto const &new_op = it == updated_ops.end() ? o.second : it->second;
-      (new_op.dagger ? x : y)[new_op.block_index].emplace_back(tau, new_op.inner_index);
+    for (int i = 0; i < candidates.size(); ++i) {
+      auto const &c = candidates[i];
+      if (selected[i] && needs_refill(c.new_op.block_index))
+        (c.new_op.dagger ? x : y)[c.new_op.block_index].emplace_back(c.tau, c.new_op.inner_index);
     }
-
+    auto by_time = [](std::pair<time_pt, int> const &a, std::pair<time_pt, int> const &b) { return a.first > b.first; };
     for (auto block_index : affected_blocks) {
+      if (!needs_refill(block_index)) continue;
       // New configuration is not compatible with gf_struct
       if (x[block_index].size() != y[block_index].size()) return 0;
+      std::sort(x[block_index].begin(), x[block_index].end(), by_time);
+      std::sort(y[block_index].begin(), y[block_index].end(), by_time);
     }
 
-    // Try refill determinants
+    // Try the determinant updates
     mc_weight_t det_ratio = 1;
     for (auto block_index : affected_blocks) {
-      auto &det                   = data.dets[block_index];
-      mc_weight_t block_det_ratio = det.try_refill(x[block_index], y[block_index]);
+      auto &det     = data.dets[block_index];
+      auto cx       = changed_x[block_index];
+      auto cy       = changed_y[block_index];
+      bool low_rank = max_woodbury_rank > 0 && needs_refill(block_index) && prepare_woodbury(block_index);
+      mc_weight_t block_det_ratio;
+      if (low_rank)
+        block_det_ratio = woodbury_ratio(block_index);
+      else if (needs_refill(block_index))
+        block_det_ratio = det.try_refill(x[block_index], y[block_index]);
+      else if (n_changed_x[block_index] && n_changed_y[block_index])
+        block_det_ratio = det.try_change_col_row(cx->det_pos, cy->det_pos, {cx->tau, cx->new_op.inner_index}, {cy->tau, cy->new_op.inner_index});
+      else if (n_changed_x[block_index])
+        block_det_ratio = det.try_change_row(cx->det_pos, {cx->tau, cx->new_op.inner_index});
+      else if (n_changed_y[block_index])
+        block_det_ratio = det.try_change_col(cy->det_pos, {cy->tau, cy->new_op.inner_index});
+      else
+        continue; // Nothing changes in this block
+      (low_rank ? woodbury_blocks : tried_blocks).push_back(block_index);
       if (block_det_ratio == .0) {
 #ifdef EXT_DEBUG
         std::cerr << "block_det_ratio[" << block_index << "] = 0" << std::endl;
@@ -170,7 +373,12 @@ namespace triqs_cthyb {
     for (auto const &o : updated_ops) data.config.replace(o.first, o.second);
     config.finalize();
 
-    for (auto block_index : affected_blocks) data.dets[block_index].complete_operation();
+    for (auto block_index : tried_blocks) data.dets[block_index].complete_operation();
+    // The ratio of these dets was computed without a try, the inverse is rebuilt now
+    for (auto block_index : woodbury_blocks) {
+      data.dets[block_index].try_refill(x[block_index], y[block_index]);
+      data.dets[block_index].complete_operation();
+    }
 
     data.update_sign();
     data.atomic_weight      = new_atomic_weight;
@@ -191,7 +399,7 @@ namespace triqs_cthyb {
 
     config.finalize();
     data.imp_trace.cancel_replace();
-    for (auto block_index : affected_blocks) data.dets[block_index].reject_last_try();
+    for (auto block_index : tried_blocks) data.dets[block_index].reject_last_try();
 
 #ifdef EXT_DEBUG
     std::cerr << "* Move move_global '" << name << "' rejected" << std::endl;
@@ -42,8 +42,35 @@ namespace triqs_cthyb {
     // Substitutions as mappings (old linear index) -> (new op_desc)
     std::vector<op_desc> substitute_c, substitute_c_dag;
 
-    // Indices of blocks potentially affected by this move
+    // Indices of blocks potentially affected by this move, and of those holding operators to be substituted
     std::set<int> affected_blocks;
+    std::vector<int> source_blocks;
+
+    // Linear index of each (block, inner) pair
+    std::vector<std::vector<int>> lin_index;
+
+    // An operator which can be substituted, and its position in the determinant of its (old) block
+    struct candidate_t {
+      time_pt tau;
+      op_desc new_op;
+      int old_block, det_pos;
+    };
+
+    // Buffers reused from one attempt to the next
+    std::vector<candidate_t> candidates;                   // Substitutable operators, from the largest time down
+    std::vector<int> tree;                                 // Fenwick tree counting the candidates still selected
+    std::vector<char> selected;                            // Is a candidate selected?
+    std::vector<std::vector<char>> x_changed, y_changed;   // Is the row/column of a det substituted?
+    std::vector<int> n_changed_x, n_changed_y;             // Number of rows/columns substituted in each block, staying in the block
+    std::vector<candidate_t const *> changed_x, changed_y; // The last of them
+    std::vector<char> block_moved;                         // Does an operator leave or enter the block?
+    std::vector<int> tried_blocks;                         // Blocks whose det has a pending try
+    std::vector<int> woodbury_blocks;                      // Blocks whose det ratio was computed by a low-rank update
+    std::vector<int> rows_out, cols_out;                   // Positions of the rows/columns replaced in a det
+    std::vector<std::pair<time_pt, int>> rows_in, cols_in; // Arguments of the new rows/columns
+
+    // Largest number of replaced rows and columns of a det for which the ratio is computed by a low-rank update
+    int max_woodbury_rank;
 
     // Operators to be updated
     configuration::oplist_t updated_ops;
@@ -52,11 +79,21 @@ namespace triqs_cthyb {
     std::vector<std::vector<det_type::x_type>> x;
     std::vector<std::vector<det_type::y_type>> y;
 
+    // Select the subset of the candidates to be updated
+    void select_candidates();
+
+    // Prepare the low-rank update of a det whose size does not change, returns false if a refill is better
+    bool prepare_woodbury(int block_index);
+
+    // Det ratio of the prepared low-rank update
+    mc_weight_t woodbury_ratio(int block_index);
+
     h_scalar_t new_atomic_weight;      // Proposed value of the trace or norm
     h_scalar_t new_atomic_reweighting; // Proposed value of the reweighting
 
     public:
-    move_global(std::string const &name, indices_map_t const &substitution_map, qmc_data &data, mc_tools::random_generator &rng);
+    move_global(std::string const &name, indices_map_t const &substitution_map, qmc_data &data, mc_tools::random_generator &rng,
+                int max_woodbury_rank = 0);
 
     mc_weight_t attempt();
     mc_weight_t accept();
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./global_transform.hpp"
+
+namespace triqs_cthyb {
+
+  move_global_transform::move_global_transform(global_transform_t kind, qmc_data &data, mc_tools::random_generator &rng)
+     : data(data), config(data.config), rng(rng), kind(kind), x(data.dets.size()), y(data.dets.size()) {}
+
+  mc_weight_t move_global_transform::attempt() {
+
+#ifdef EXT_DEBUG
+    std::cerr << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>" << std::endl;
+    std::cerr << "In config " << config.get_id() << std::endl;
+    std::cerr << "* Attempt for move_global_transform (" << int(kind) << ")" << std::endl;
+#endif
+
+    tried_blocks.clear();
+    if (config.size() == 0) return 0;
+
+    // The transformed configuration. Each transformation is a bijection of the time grid, so that no
+    // two operators can end up at the same time, and the proposal is symmetric.
+    new_ops.clear();
+    switch (kind) {
+      case global_transform_t::time_shift: {
+        auto dtau = data.tau_seg.get_random_pt(rng);
+        for (auto const &o : config) new_ops.emplace_back(o.first + dtau, o.second);
+        break;
+      }
+      case global_transform_t::time_reflection:
+        for (auto const &o : config) new_ops.emplace_back(data.tau_seg.get_upper_pt() - o.first, o.second);
+        break;
+      case global_transform_t::particle_hole:
+        for (auto const &o : config) {
+          auto const &op = o.second;
+          new_ops.emplace_back(o.first, op_desc{op.block_index, op.inner_index, !op.dagger, op.linear_index});
+        }
+        break;
+    }
+    std::sort(new_ops.begin(), new_ops.end(), [](auto const &a, auto const &b) { return a.first > b.first; });
+
+    // Every det is refilled, the number of rows and columns of each block being unchanged
+    for (auto &v : x) v.clear();
+    for (auto &v : y) v.clear();
+    for (auto const &o : new_ops) (o.second.dagger ? x : y)[o.second.block_index].emplace_back(o.first, o.second.inner_index);
+
+    mc_weight_t det_ratio = 1;
+    for (int block_index = 0; block_index < data.dets.size(); ++block_index) {
+      if (data.dets[block_index].size() == 0) continue;
+      auto block_det_ratio = data.dets[block_index].try_refill(x[block_index], y[block_index]);
+      tried_blocks.push_back(block_index);
+      if (block_det_ratio == .0) return 0;
+      det_ratio *= block_det_ratio;
+    }
+
+    // For quick abandon
+    double random_number = rng.preview();
+    if (random_number == 0.0) return 0;
+    double p_yee = std::abs(det_ratio / data.atomic_weight);
+
+    data.imp_trace.try_rebuild(new_ops);
+
+    // computation of the new trace
+    std::tie(new_atomic_weight, new_atomic_reweighting) = data.imp_trace.compute(p_yee, random_number);
+    if (new_atomic_weight == 0.0) return 0;
+    auto atomic_weight_ratio = new_atomic_weight / data.atomic_weight;
+    if (!isfinite(atomic_weight_ratio))
+      TRIQS_RUNTIME_ERROR << "atomic_weight_ratio not finite " << new_atomic_weight << " " << data.atomic_weight << " "
+                          << new_atomic_weight / data.atomic_weight << " in config " << config.get_id();
+
+    mc_weight_t p = atomic_weight_ratio * det_ratio;
+
+#ifdef EXT_DEBUG
+    std::cerr << "Trace ratio: " << atomic_weight_ratio << '\t';
+    std::cerr << "Det ratio: " << det_ratio << '\t';
+    std::cerr << "Weight: " << p << std::endl;
+#endif
+
+    return p;
+  }
+
+  mc_weight_t move_global_transform::accept() {
+
+    config.clear();
+    for (auto const &o : new_ops) config.insert(o.first, o.second);
+    config.finalize();
+
+    for (auto block_index : tried_blocks) data.dets[block_index].complete_operation();
+
+    data.update_sign();
+    data.atomic_weight      = new_atomic_weight;
+    data.atomic_reweighting = new_atomic_reweighting;
+
+    data.imp_trace.confirm_rebuild();
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_global_transform accepted" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+    for (auto const &det : data.dets) check_det_sequence(det, config.get_id());
+#endif
+
+    return data.current_sign / data.old_sign;
+  }
+
+  void move_global_transform::reject() {
+
+    config.finalize();
+    data.imp_trace.cancel_rebuild();
+    for (auto block_index : tried_blocks) data.dets[block_index].reject_last_try();
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_global_transform rejected" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+#endif
+  }
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mc_tools.hpp>
+#include "../qmc_data.hpp"
+
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /// Global moves applying the same transformation to every operator of the configuration
+  enum class global_transform_t {
+    time_shift,      // tau -> tau + dtau (cyclically), dtau uniform in [0, beta)
+    time_reflection, // tau -> beta - tau
+    particle_hole    // c <-> c^+ at the same time
+  };
+
+  /// Each attempt refills every det and rebuilds the trace tree from scratch, i.e. costs O(n^3) in the number n of
+  /// operators of a block, much more than a local move : these moves should be proposed with a small probability.
+  class move_global_transform {
+
+    qmc_data &data;
+    configuration &config;
+    mc_tools::random_generator &rng;
+    global_transform_t kind;
+
+    // Buffers reused from one attempt to the next
+    std::vector<std::pair<time_pt, op_desc>> new_ops;       // The transformed configuration, from the largest time down
+    std::vector<std::vector<std::pair<time_pt, int>>> x, y; // New arguments of the dets
+    std::vector<int> tried_blocks;                          // Blocks whose det has a pending try
+
+    h_scalar_t new_atomic_weight;      // Proposed value of the trace or norm
+    h_scalar_t new_atomic_reweighting; // Proposed value of the reweighting
+
+    public:
+    move_global_transform(global_transform_t kind, qmc_data &data, mc_tools::random_generator &rng);
+
+    mc_weight_t attempt();
+    mc_weight_t accept();
+    void reject();
+  };
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mc_tools.hpp>
+#include "../qmc_data.hpp"
+#include "./importance_table.hpp"
+
+#include <memory>
+
+namespace triqs_cthyb {
+
+  // Removal of C, C^dagger operator, reverse of move_insert_c_cdag_importance
+  class move_remove_c_cdag_importance {
+
+    qmc_data &data;
+    configuration &config;
+    mc_tools::random_generator &rng;
+    int block_index;
+    std::shared_ptr<hyb_importance_table const> table; // Proposal distribution of the insertion
+    h_scalar_t new_atomic_weight, new_atomic_reweighting;
+    time_pt tau1, tau2;
+
+    public:
+    move_remove_c_cdag_importance(int block_index, std::shared_ptr<hyb_importance_table const> table, qmc_data &data,
+                                  mc_tools::random_generator &rng);
+
+    mc_weight_t attempt();
+    mc_weight_t accept();
+    void reject();
+  };
+}
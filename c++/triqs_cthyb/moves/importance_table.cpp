@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./importance_table.hpp"
+
+namespace triqs_cthyb {
+
+  // Vose's construction of the table
+  alias_table::alias_table(std::vector<double> const &weights) : prob_(weights.size()), cut(weights.size(), 1.0), alias(weights.size()) {
+
+    int n      = weights.size();
+    double sum = 0;
+    for (auto w : weights) sum += w;
+    if (n == 0 || !(sum > 0)) TRIQS_RUNTIME_ERROR << "alias_table: the weights must be non-negative and not all zero";
+
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; ++i) {
+      prob_[i]  = weights[i] / sum;
+      scaled[i] = prob_[i] * n;
+      alias[i]  = i;
+      (scaled[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      int s = small.back(), l = large.back();
+      small.pop_back();
+      cut[s]   = scaled[s];
+      alias[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // What is left is 1 up to rounding errors
+  }
+
+  // ------------------------------------------------------------------
+
+  hyb_importance_table::hyb_importance_table(gf_const_view<imtime, delta_target_t> delta, double mixing)
+     : block_size(delta.data().shape()[1]), n_bins(delta.mesh().size() - 1), bin_width(delta.mesh().domain().beta / n_bins) {
+
+    if (mixing < 0 || mixing > 1) TRIQS_RUNTIME_ERROR << "hyb_importance_table: the mixing must be in [0, 1], got " << mixing;
+
+    auto const &d = delta.data();
+    std::vector<double> weights(block_size * block_size * n_bins);
+    double sum = 0;
+    for (int a = 0; a < block_size; ++a)
+      for (int b = 0; b < block_size; ++b)
+        for (int bin = 0; bin < n_bins; ++bin) {
+          auto &w = weights[(a * block_size + b) * n_bins + bin];
+          w       = (std::abs(d(bin, a, b)) + std::abs(d(bin + 1, a, b))) / 2;
+          sum += w;
+        }
+
+    // Without hybridization, the proposals are uniform
+    if (!(sum > 0)) mixing = 1;
+    for (auto &w : weights) w = (mixing < 1 ? (1 - mixing) * w / sum : 0) + mixing / weights.size();
+    table = alias_table(weights);
+  }
+}
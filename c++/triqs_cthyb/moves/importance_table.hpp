@@ -0,0 +1,86 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "../qmc_data.hpp"
+
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /// Walker's alias method : draws the index i with probability p_i in O(1)
+  class alias_table {
+
+    std::vector<double> prob_; // Normalized probabilities
+    std::vector<double> cut;   // Bucket i gives i below cut[i], alias[i] above
+    std::vector<int> alias;
+
+    public:
+    alias_table() = default;
+
+    /// Build the table from non-negative weights, not all zero
+    explicit alias_table(std::vector<double> const &weights);
+
+    int size() const { return prob_.size(); }
+
+    /// Probability of the index i
+    double prob(int i) const { return prob_[i]; }
+
+    /// Draw an index
+    template <typename RNG> int operator()(RNG &rng) const {
+      int i = rng(size());
+      return (rng() < cut[i] ? i : alias[i]);
+    }
+  };
+
+  /**
+   * Proposal of the inner indices (a, b) and of the time difference tau = tau_a - tau_b (cyclic, in [0, beta))
+   * of a pair C^dagger_a(tau_a) C_b(tau_b), with a density proportional to |Delta_ab(tau)|.
+   * The time differences are binned on the mesh of Delta, and the density is constant within a bin.
+   * A fraction mixing of the proposals is uniform, so that all pairs can be reached.
+   */
+  class hyb_importance_table {
+
+    int block_size, n_bins;
+    double bin_width;
+    alias_table table; // Index (a * block_size + b) * n_bins + bin
+
+    public:
+    hyb_importance_table(gf_const_view<imtime, delta_target_t> delta, double mixing);
+
+    struct draw_t {
+      int a, b;
+      double tau;
+    };
+
+    /// Draw (a, b, tau)
+    template <typename RNG> draw_t operator()(RNG &rng) const {
+      int i   = table(rng);
+      int bin = i % n_bins;
+      return {i / n_bins / block_size, (i / n_bins) % block_size, (bin + rng()) * bin_width};
+    }
+
+    /// Probability density of (a, b, tau)
+    double density(int a, int b, double tau) const {
+      int bin = std::min(std::max(int(tau / bin_width), 0), n_bins - 1);
+      return table.prob((a * block_size + b) * n_bins + bin) / bin_width;
+    }
+  };
+}
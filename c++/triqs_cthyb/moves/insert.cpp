@@ -30,14 +30,17 @@ namespace triqs_cthyb {
   }
 
   move_insert_c_cdag::move_insert_c_cdag(int block_index, int block_size, std::string const &block_name, qmc_data &data,
-                                         mc_tools::random_generator &rng, histo_map_t *histos)
+                                         mc_tools::random_generator &rng, histo_map_t *histos, double window_length)
      : data(data),
        config(data.config),
        rng(rng),
        block_index(block_index),
        block_size(block_size),
-       histo_proposed(add_histo("insert_length_proposed_" + block_name, histos)),
-       histo_accepted(add_histo("insert_length_accepted_" + block_name, histos)) {}
+       window_length(std::min(window_length, config.beta() / 2)),
+       windowed(window_length < config.beta() / 2),
+       window(data.tau_seg.make_time_pt(this->window_length)),
+       histo_proposed(add_histo((windowed ? "insert_window_length_proposed_" : "insert_length_proposed_") + block_name, histos)),
+       histo_accepted(add_histo((windowed ? "insert_window_length_accepted_" : "insert_length_accepted_") + block_name, histos)) {}
 
   mc_weight_t move_insert_c_cdag::attempt() {
 
@@ -53,8 +56,13 @@ namespace triqs_cthyb {
     op2 = op_desc{block_index, rs2, false, data.linindex[std::make_pair(block_index, rs2)]};
 
     // Choice of times for insertion. Find the time as double and them put them on the grid.
+    // In a window, tau2 is chosen within the window around tau1
     tau1 = data.tau_seg.get_random_pt(rng);
-    tau2 = data.tau_seg.get_random_pt(rng);
+    if (windowed) {
+      double shift = (2 * rng() - 1) * window_length;
+      tau2         = (shift >= 0 ? tau1 + data.tau_seg.make_time_pt(shift) : tau1 - data.tau_seg.make_time_pt(-shift));
+    } else
+      tau2 = data.tau_seg.get_random_pt(rng);
 
 #ifdef EXT_DEBUG
     std::cerr << "* Proposing to insert:" << std::endl;
@@ -93,11 +101,18 @@ namespace triqs_cthyb {
       if (det.get_y(num_c).first < tau2) break;
     }
 
+    // In a window, number of C within the window around tau1 after the insertion, among which the reverse move chooses
+    int n_window = 1;
+    if (windowed)
+      for (int i = 0; i < det_size; ++i)
+        if (in_window(det.get_y(i).first, tau1, window)) ++n_window;
+
     // Insert in the det. Returns the ratio of dets (Cf det_manip doc).
     auto det_ratio = det.try_insert(num_c_dag, num_c, {tau1, op1.inner_index}, {tau2, op2.inner_index});
 
     // proposition probability
-    mc_weight_t t_ratio = std::pow(block_size * config.beta() / double(det.size() + 1), 2);
+    mc_weight_t t_ratio = (windowed ? block_size * block_size * config.beta() * 2 * window_length / double((det_size + 1) * n_window)
+                                    : std::pow(block_size * config.beta() / double(det.size() + 1), 2));
 
     // For quick abandon
     double random_number = rng.preview();
@@ -19,18 +19,28 @@
  *
  ******************************************************************************/
 #pragma once
+#include <limits>
 #include <triqs/mc_tools.hpp>
 #include "../qmc_data.hpp"
 
 namespace triqs_cthyb {
 
+  // Are two times closer than window on the circle of length beta?
+  inline bool in_window(time_pt const &t1, time_pt const &t2, time_pt const &window) {
+    return !(window < t1 - t2) || !(window < t2 - t1);
+  }
+
   // Insertion of C, C^dagger operator
+  // With a window_length smaller than beta/2, the C is proposed at a distance smaller than window_length from the C^dagger
   class move_insert_c_cdag {
 
     qmc_data &data;
     configuration &config;
     mc_tools::random_generator &rng;
     int block_index, block_size;
+    double window_length;                       // Largest distance between the inserted operators
+    bool windowed;                              // Is window_length smaller than beta/2?
+    time_pt window;                             // window_length on the time grid
     histogram *histo_proposed, *histo_accepted; // Analysis histograms
     double dtau;
     h_scalar_t new_atomic_weight, new_atomic_reweighting;
@@ -41,7 +51,7 @@ namespace triqs_cthyb {
 
     public:
     move_insert_c_cdag(int block_index, int block_size, std::string const &block_name, qmc_data &data, mc_tools::random_generator &rng,
-                       histo_map_t *histos);
+                       histo_map_t *histos, double window_length = std::numeric_limits<double>::infinity());
 
     mc_weight_t attempt();
     mc_weight_t accept();
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./pair_shift.hpp"
+
+namespace triqs_cthyb {
+
+  move_shift_pair::move_shift_pair(int block_index, double window_length, qmc_data &data, mc_tools::random_generator &rng)
+     : data(data), config(data.config), rng(rng), block_index(block_index), window_length(window_length) {}
+
+  mc_weight_t move_shift_pair::attempt() {
+
+#ifdef EXT_DEBUG
+    std::cerr << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>" << std::endl;
+    std::cerr << "In config " << config.get_id() << std::endl;
+    std::cerr << "* Attempt for move_shift_pair (block " << block_index << ")" << std::endl;
+#endif
+
+    auto &det    = data.dets[block_index];
+    int det_size = det.size();
+    if (det_size == 0) return 0; // nothing to shift
+
+    // Pick up a C^dagger and a C at random
+    int num_c_dag = rng(det_size), num_c = rng(det_size);
+    auto x = det.get_x(num_c_dag), y = det.get_y(num_c);
+    tau_old1 = x.first;
+    tau_old2 = y.first;
+    op1      = op_desc{block_index, x.second, true, data.linindex[std::make_pair(block_index, x.second)]};
+    op2      = op_desc{block_index, y.second, false, data.linindex[std::make_pair(block_index, y.second)]};
+
+    // Shift both by the same random time. The default window is the mean distance between the operators which
+    // must not be passed, and only depends on det_size, which the move does not change : the proposal stays symmetric.
+    double window = std::min(window_length > 0 ? window_length : config.beta() / det_size, config.beta() / 2);
+    double shift  = (2 * rng() - 1) * window;
+    if (shift == 0) return 0;
+    auto dt  = data.tau_seg.make_time_pt(std::abs(shift));
+    tau_new1 = (shift > 0 ? tau_old1 + dt : tau_old1 - dt);
+    tau_new2 = (shift > 0 ? tau_old2 + dt : tau_old2 - dt);
+
+    // The operators must keep their positions in the det, i.e. not pass their neighbours nor go through
+    // beta or 0, so that no row or column is moved. This condition is the same for the reverse move.
+    auto keeps_position = [&](auto const &get, int i, time_pt const &t_old, time_pt const &t_new) {
+      if ((shift > 0) != (t_new > t_old)) return false;
+      if (i > 0 && !(t_new < get(i - 1).first)) return false;
+      if (i < det_size - 1 && !(get(i + 1).first < t_new)) return false;
+      return true;
+    };
+    if (!keeps_position([&det](int i) { return det.get_x(i); }, num_c_dag, tau_old1, tau_new1)) return 0;
+    if (!keeps_position([&det](int i) { return det.get_y(i); }, num_c, tau_old2, tau_new2)) return 0;
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Proposing to shift:" << std::endl;
+    std::cerr << op1 << " tau = " << tau_old1 << " to " << tau_new1 << std::endl;
+    std::cerr << op2 << " tau = " << tau_old2 << " to " << tau_new2 << std::endl;
+#endif
+
+    // --- Modify the tree (cf move_shift_operator)
+    data.imp_trace.try_delete(num_c_dag, block_index, true);
+    data.imp_trace.try_delete(num_c, block_index, false);
+    try {
+      data.imp_trace.try_insert(tau_new1, op1);
+      data.imp_trace.try_insert(tau_new2, op2);
+    } catch (rbt_insert_error const &) {
+      std::cerr << "Insert error : recovering ... " << std::endl;
+      data.imp_trace.cancel_shift();
+      return 0;
+    }
+
+    // --- Compute the det ratio
+    auto det_ratio = det.try_change_col_row(num_c_dag, num_c, {tau_new1, op1.inner_index}, {tau_new2, op2.inner_index});
+
+    // for quick abandon
+    double random_number = rng.preview();
+    if (random_number == 0.0) return 0;
+    double p_yee = std::abs(det_ratio / data.atomic_weight);
+
+    // --- Compute the atomic_weight ratio
+    std::tie(new_atomic_weight, new_atomic_reweighting) = data.imp_trace.compute(p_yee, random_number);
+    if (new_atomic_weight == 0.0) {
+#ifdef EXT_DEBUG
+      std::cerr << "atomic_weight == 0" << std::endl;
+#endif
+      return 0;
+    }
+    auto atomic_weight_ratio = new_atomic_weight / data.atomic_weight;
+    if (!isfinite(atomic_weight_ratio))
+      TRIQS_RUNTIME_ERROR << "atomic_weight_ratio not finite " << new_atomic_weight << " " << data.atomic_weight << " "
+                          << new_atomic_weight / data.atomic_weight << " in config " << config.get_id();
+
+    // --- Compute the weight
+    mc_weight_t p = atomic_weight_ratio * det_ratio;
+
+#ifdef EXT_DEBUG
+    std::cerr << "Trace ratio: " << atomic_weight_ratio << '\t';
+    std::cerr << "Det ratio: " << det_ratio << '\t';
+    std::cerr << "Weight: " << p << std::endl;
+#endif
+
+    return p;
+  }
+
+  mc_weight_t move_shift_pair::accept() {
+
+    // Update the tree
+    data.imp_trace.confirm_shift();
+
+    // Update the configuration
+    config.erase(tau_old1);
+    config.erase(tau_old2);
+    config.insert(tau_new1, op1);
+    config.insert(tau_new2, op2);
+    config.finalize();
+
+    // Update the determinant
+    data.dets[block_index].complete_operation();
+    data.update_sign();
+
+    data.atomic_weight      = new_atomic_weight;
+    data.atomic_reweighting = new_atomic_reweighting;
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_shift_pair accepted" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+    check_det_sequence(data.dets[block_index], config.get_id());
+#endif
+
+    return data.current_sign / data.old_sign;
+  }
+
+  void move_shift_pair::reject() {
+
+    config.finalize();
+    data.imp_trace.cancel_shift();
+    data.dets[block_index].reject_last_try();
+
+#ifdef EXT_DEBUG
+    std::cerr << "* Move move_shift_pair rejected" << std::endl;
+    std::cerr << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<" << std::endl;
+    check_det_sequence(data.dets[block_index], config.get_id());
+#endif
+  }
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mc_tools.hpp>
+#include "../qmc_data.hpp"
+
+namespace triqs_cthyb {
+
+  // Shift a C, C^dagger pair of a block rigidly, by the same time
+  class move_shift_pair {
+
+    qmc_data &data;
+    configuration &config;
+    mc_tools::random_generator &rng;
+    int block_index;
+    double window_length; // Largest shift (0: the mean distance beta / n between the n C^dagger of the block)
+    h_scalar_t new_atomic_weight, new_atomic_reweighting;
+    time_pt tau_old1, tau_old2, tau_new1, tau_new2; // 1 : C^dagger, 2 : C
+    op_desc op1, op2;
+
+    public:
+    move_shift_pair(int block_index, double window_length, qmc_data &data, mc_tools::random_generator &rng);
+
+    mc_weight_t attempt();
+    mc_weight_t accept();
+    void reject();
+  };
+}
@@ -30,14 +30,17 @@ namespace triqs_cthyb {
   }
 
   move_remove_c_cdag::move_remove_c_cdag(int block_index, int block_size, std::string const &block_name, qmc_data &data, mc_tools::random_generator &rng,
-                     histo_map_t *histos)
+                     histo_map_t *histos, double window_length)
      : data(data),
        config(data.config),
        rng(rng),
        block_index(block_index),
        block_size(block_size),
-       histo_proposed(add_histo("remove_length_proposed_" + block_name, histos)),
-       histo_accepted(add_histo("remove_length_accepted_" + block_name, histos)) {}
+       window_length(std::min(window_length, config.beta() / 2)),
+       windowed(window_length < config.beta() / 2),
+       window(data.tau_seg.make_time_pt(this->window_length)),
+       histo_proposed(add_histo((windowed ? "remove_window_length_proposed_" : "remove_length_proposed_") + block_name, histos)),
+       histo_accepted(add_histo((windowed ? "remove_window_length_accepted_" : "remove_length_accepted_") + block_name, histos)) {}
 
   mc_weight_t move_remove_c_cdag::attempt() {
 
@@ -50,10 +53,21 @@ namespace triqs_cthyb {
     auto &det = data.dets[block_index];
 
     // Pick up a couple of C, Cdagger to remove at random
+    // In a window, the C is chosen among those within the window around the C^dagger
     // Remove the operators from the traces
     int det_size = det.size();
     if (det_size == 0) return 0; // nothing to remove
-    int num_c_dag = rng(det_size), num_c = rng(det_size);
+    int num_c_dag = rng(det_size), num_c, n_window = 1;
+    if (windowed) {
+      auto t_dag = det.get_x(num_c_dag).first;
+      c_in_window.clear();
+      for (int i = 0; i < det_size; ++i)
+        if (in_window(det.get_y(i).first, t_dag, window)) c_in_window.push_back(i);
+      if (c_in_window.empty()) return 0; // can not be reached by the windowed insertion
+      n_window = c_in_window.size();
+      num_c    = c_in_window[rng(n_window)];
+    } else
+      num_c = rng(det_size);
 
 #ifdef EXT_DEBUG
     std::cerr << "* Proposing to remove: ";
@@ -71,8 +85,10 @@ namespace triqs_cthyb {
 
     auto det_ratio = det.try_remove(num_c_dag, num_c);
 
-    // proposition probability
-    auto t_ratio = std::pow(block_size * config.beta() / double(det_size), 2); // Size of the det before the try_delete!
+    // proposition probability of the reverse move
+    // Size of the det before the try_delete!
+    mc_weight_t t_ratio = (windowed ? block_size * block_size * config.beta() * 2 * window_length / double(det_size * n_window)
+                                    : std::pow(block_size * config.beta() / double(det_size), 2));
 
     // For quick abandon
     double random_number = rng.preview();
@@ -22,26 +22,32 @@
 #include <algorithm>
 #include <triqs/mc_tools.hpp>
 #include "../qmc_data.hpp"
+#include "./insert.hpp"
 
 namespace triqs_cthyb {
 
   // Removal of C, C^dagger operator
+  // With a window_length smaller than beta/2, only the C at a distance smaller than window_length from the C^dagger are proposed
   class move_remove_c_cdag {
 
     qmc_data &data;
     configuration &config;
     mc_tools::random_generator &rng;
     int block_index, block_size;
+    double window_length;                       // Largest distance between the removed operators
+    bool windowed;                              // Is window_length smaller than beta/2?
+    time_pt window;                             // window_length on the time grid
     histogram *histo_proposed, *histo_accepted; // Analysis histograms
     double dtau;
     h_scalar_t new_atomic_weight, new_atomic_reweighting;
     time_pt tau1, tau2;
+    std::vector<int> c_in_window; // Positions in the det of the C within the window
 
     histogram *add_histo(std::string const &name, histo_map_t *histos);
 
     public:
     move_remove_c_cdag(int block_index, int block_size, std::string const &block_name, qmc_data &data, mc_tools::random_generator &rng,
-                       histo_map_t *histos);
+                       histo_map_t *histos, double window_length = std::numeric_limits<double>::infinity());
 
     mc_weight_t attempt();
     mc_weight_t accept();
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include "./replica_exchange.hpp"
+
+#include <utility>
+
+namespace triqs_cthyb {
+
+  mc_weight_t replica_swap::attempt() {
+
+    new_ops_a.assign(b.config.begin(), b.config.end());
+    new_ops_b.assign(a.config.begin(), a.config.end());
+    old_sign_b = b.mc_sign();
+
+    a.imp_trace.try_rebuild(new_ops_a);
+    b.imp_trace.try_rebuild(new_ops_b);
+    tried = true;
+
+    // The dets and the permutation signs cancel in the ratio
+    std::tie(new_atomic_weight_a, new_atomic_reweighting_a) = a.imp_trace.compute();
+    if (new_atomic_weight_a == 0.0) return 0;
+    std::tie(new_atomic_weight_b, new_atomic_reweighting_b) = b.imp_trace.compute();
+    if (new_atomic_weight_b == 0.0) return 0;
+
+    auto ratio_a = new_atomic_weight_a / a.atomic_weight, ratio_b = new_atomic_weight_b / b.atomic_weight;
+    if (!isfinite(ratio_a) || !isfinite(ratio_b))
+      TRIQS_RUNTIME_ERROR << "atomic_weight_ratio not finite in a replica exchange " << ratio_a << " " << ratio_b << " in config "
+                          << a.config.get_id();
+    return ratio_a * ratio_b;
+  }
+
+  mc_weight_t replica_swap::accept() {
+
+    for (auto [data, ops] : {std::pair{&a, &new_ops_a}, std::pair{&b, &new_ops_b}}) {
+      data->config.clear();
+      for (auto const &o : *ops) data->config.insert(o.first, o.second);
+      data->config.finalize();
+      data->imp_trace.confirm_rebuild();
+    }
+    std::swap(a.dets, b.dets);
+
+    a.atomic_weight      = new_atomic_weight_a;
+    a.atomic_reweighting = new_atomic_reweighting_a;
+    b.atomic_weight      = new_atomic_weight_b;
+    b.atomic_reweighting = new_atomic_reweighting_b;
+    a.update_sign();
+    b.update_sign();
+    tried = false;
+
+    return old_sign_b / b.mc_sign();
+  }
+
+  void replica_swap::reject() {
+    if (!tried) return;
+    a.config.finalize();
+    b.config.finalize();
+    a.imp_trace.cancel_rebuild();
+    b.imp_trace.cancel_rebuild();
+    tried = false;
+  }
+
+  // ------------------------------------------------------------------
+
+  replica_ladder::replica_ladder(std::vector<qmc_data *> replicas, segment_t run_segment)
+     : run_segment(std::move(run_segment)),
+       n_attempted_(replicas.size() - 1, 0),
+       n_accepted_(replicas.size() - 1, 0),
+       go(replicas.size() - 1, 1) {
+    if (replicas.size() < 2) TRIQS_RUNTIME_ERROR << "replica_ladder: at least two replicas are needed";
+    swaps.reserve(replicas.size() - 1);
+    for (int k = 0; k + 1 < replicas.size(); ++k) swaps.emplace_back(*replicas[k], *replicas[k + 1]);
+    for (int k = 1; k < replicas.size(); ++k) threads.emplace_back([this, k]() { thread_loop(k); });
+  }
+
+  replica_ladder::~replica_ladder() {
+    try {
+      stop();
+    } catch (...) {} // the errors are reported by an explicit stop()
+  }
+
+  void replica_ladder::thread_loop(int k) {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mtx);
+          cv.wait(lock, [this, k]() { return stopping || go[k - 1]; });
+          if (stopping) return;
+          go[k - 1] = 0;
+        }
+        run_segment(k, stopping);
+        ++n_waiting;
+      }
+    } catch (...) {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (!error) error = std::current_exception();
+    }
+  }
+
+  void replica_ladder::exchange_others(mc_tools::random_generator &rng) {
+    for (int k = 1 + parity; k < swaps.size(); k += 2) {
+      auto r = swaps[k].attempt();
+      bool accepted = (rng() < std::min(1.0, std::abs(r)));
+      if (accepted)
+        swaps[k].accept();
+      else
+        swaps[k].reject();
+      count(k, accepted);
+    }
+    parity = 1 - parity;
+  }
+
+  void replica_ladder::release() {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      n_waiting = 0;
+      for (auto &g : go) g = 1;
+    }
+    cv.notify_all();
+  }
+
+  void replica_ladder::stop() {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      stopping = true;
+    }
+    cv.notify_all();
+    for (auto &t : threads)
+      if (t.joinable()) t.join();
+    if (error) std::rethrow_exception(std::exchange(error, nullptr));
+  }
+
+  // ------------------------------------------------------------------
+
+  mc_weight_t move_replica_exchange::attempt() {
+    tried = ladder.waiting();
+    if (!tried) return 0;
+    ladder.exchange_others(rng);
+    return ladder.swap(0).attempt();
+  }
+
+  mc_weight_t move_replica_exchange::accept() {
+    auto s = ladder.swap(0).accept();
+    ladder.count(0, true);
+    ladder.release();
+    return s;
+  }
+
+  void move_replica_exchange::reject() {
+    if (!tried) return;
+    ladder.swap(0).reject();
+    ladder.count(0, false);
+    ladder.release();
+  }
+}
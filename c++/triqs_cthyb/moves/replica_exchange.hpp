@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mc_tools.hpp>
+#include "../qmc_data.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /**
+   * Exchange of the configurations of two replicas of the problem
+   *
+   * The replicas share Delta and differ by their local Hamiltonian, so that the determinants and the
+   * permutation sign of a configuration are the same in both : only the traces are recomputed, and the
+   * determinants are swapped along with the configurations.
+   * The interface is that of a move, for the replica a.
+   */
+  class replica_swap {
+
+    qmc_data &a, &b;
+    std::vector<std::pair<time_pt, op_desc>> new_ops_a, new_ops_b; // The exchanged configurations
+    h_scalar_t new_atomic_weight_a, new_atomic_reweighting_a, new_atomic_weight_b, new_atomic_reweighting_b;
+    mc_weight_t old_sign_b; // Sign of the weight of b before the exchange
+    bool tried = false;
+
+    public:
+    replica_swap(qmc_data &a, qmc_data &b) : a(a), b(b) {}
+
+    /// Ratio of the product of the weights of both replicas
+    mc_weight_t attempt();
+
+    /// Returns the change of sign of the weight of b, which is part of the ratio but not of the sign of a
+    mc_weight_t accept();
+
+    void reject();
+  };
+
+  /**
+   * A ladder of replicas of the problem with different local Hamiltonians (e.g. scaled interactions)
+   *
+   * replicas[0] is the target replica, whose Markov chain is run (and measured) by the caller.
+   * The chain of every other replica k runs on its own thread, one segment (run_segment(k, stop)) at a
+   * time. When all of them have completed their segment, the target chain exchanges the configurations
+   * of the neighbouring replicas (move_replica_exchange) and starts the next segments : the replicas only
+   * touch each other's data while the threads wait.
+   */
+  class replica_ladder {
+
+    public:
+    using segment_t = std::function<void(int, std::atomic<bool> const &)>;
+
+    replica_ladder(std::vector<qmc_data *> replicas, segment_t run_segment);
+    ~replica_ladder();
+
+    replica_ladder(replica_ladder const &) = delete;
+    replica_ladder &operator=(replica_ladder const &) = delete;
+
+    /// Have all the other replicas completed their segment?
+    bool waiting() const { return n_waiting == int(threads.size()); }
+
+    /// Exchange of the configurations of replicas k and k + 1
+    replica_swap &swap(int k) { return swaps[k]; }
+
+    /// Try to exchange the configurations of every other pair of replicas beyond the target one (all waiting)
+    void exchange_others(mc_tools::random_generator &rng);
+
+    /// Count an exchange between replicas k and k + 1
+    void count(int k, bool accepted) {
+      ++n_attempted_[k];
+      if (accepted) ++n_accepted_[k];
+    }
+
+    /// Start the next segment of the other replicas
+    void release();
+
+    /// Stop the other replicas and rethrow the first error of their threads
+    void stop();
+
+    /// Number of attempted and accepted exchanges between replicas k and k + 1
+    std::vector<long> const &n_attempted() const { return n_attempted_; }
+    std::vector<long> const &n_accepted() const { return n_accepted_; }
+
+    private:
+    void thread_loop(int k);
+
+    std::vector<replica_swap> swaps;
+    segment_t run_segment;
+    std::vector<long> n_attempted_, n_accepted_;
+    int parity = 0; // of the pairs exchanged by exchange_others
+
+    std::atomic<int> n_waiting{0};
+    std::atomic<bool> stopping{false};
+    std::vector<char> go; // go[k - 1] : start the next segment of replica k
+    std::exception_ptr error;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::thread> threads;
+  };
+
+  /// Exchange of the configurations of the target replica and the next one, attempted when the other replicas wait
+  class move_replica_exchange {
+
+    replica_ladder &ladder;
+    mc_tools::random_generator &rng;
+    bool tried = false;
+
+    public:
+    move_replica_exchange(replica_ladder &ladder, mc_tools::random_generator &rng) : ladder(ladder), rng(rng) {}
+
+    mc_weight_t attempt();
+    mc_weight_t accept();
+    void reject();
+  };
+}
@@ -29,14 +29,29 @@ namespace triqs_cthyb {
     return &(new_histo.first->second);
   }
 
-  move_shift_operator::move_shift_operator(qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos)
+  move_shift_operator::move_shift_operator(qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos, double window_length,
+                                           bool gaussian)
      : data(data),
        config(data.config),
        rng(rng),
        block_index(0),
+       window_length(window_length),
+       gaussian(gaussian),
        histo_proposed(add_histo("shift_length_proposed", histos)),
        histo_accepted(add_histo("shift_length_accepted", histos)) {}
 
+  // tau_new = tau_old + a random shift, with a distribution symmetric under shift -> -shift. False if the shift is too long.
+  bool move_shift_operator::local_shift() {
+    double shift;
+    if (gaussian) // Box-Muller
+      shift = window_length * std::sqrt(-2 * std::log(1 - rng())) * std::cos(2 * M_PI * rng());
+    else
+      shift = (2 * rng() - 1) * window_length;
+    if (std::abs(shift) >= config.beta()) return false;
+    tau_new = (shift >= 0 ? tau_old + data.tau_seg.make_time_pt(shift) : tau_old - data.tau_seg.make_time_pt(-shift));
+    return tau_new != tau_old;
+  }
+
   mc_weight_t move_shift_operator::attempt() {
 
 #ifdef EXT_DEBUG
@@ -57,12 +72,8 @@ namespace triqs_cthyb {
     }
     const int op_pos_in_config = rng(config_size);
 
-    // --- Find operator (and its characteristics) from the configuration
-    auto itconfig = config.begin();
-    for (int i = 0; i < op_pos_in_config; ++i, ++itconfig)
-      ; // Get to right position in config
-    tau_old        = (*itconfig).first;
-    op_old         = (*itconfig).second;
+    // --- Find operator (and its characteristics) from the tree, which is ordered as the configuration
+    std::tie(tau_old, op_old) = data.imp_trace.get_operator(op_pos_in_config);
     block_index    = op_old.block_index;
     auto is_dagger = op_old.dagger;
 
@@ -94,12 +105,20 @@ namespace triqs_cthyb {
       // Find the c and c_dag operators at the right of op_old (at smaller times)
       // They could be the last entries (earliest times)
 
-      for (ic_dag = 0; ic_dag < det_size; ++ic_dag) { // c_dag
-        if (det.get_x(ic_dag).first < tau_old) break;
-      }
-      for (ic = 0; ic < det_size; ++ic) { // c
-        if (det.get_y(ic).first < tau_old) break;
-      }
+      // Binary search : the det stores the operators in decreasing time order
+      auto first_below = [det_size, this](auto const &get) {
+        int lo = 0, hi = det_size;
+        while (lo < hi) {
+          int mid = (lo + hi) / 2;
+          if (get(mid).first < tau_old)
+            hi = mid;
+          else
+            lo = mid + 1;
+        }
+        return lo;
+      };
+      ic_dag = first_below([&det](int i) { return det.get_x(i); }); // c_dag
+      ic     = first_below([&det](int i) { return det.get_y(i); }); // c
 
       op_pos_in_det = (is_dagger ? ic_dag : ic); // This finds the operator on the right
       --op_pos_in_det;                           // Rewind by one to find the operator
@@ -122,13 +141,21 @@ namespace triqs_cthyb {
       // Then deduce the closest one and put its distance to op_old in tL
       tL = ((tLdag - tau_old) > (tLnodag - tau_old) ? tLnodag : tLdag);
       // Choose new random time
-      tau_new = tR + data.tau_seg.get_random_pt(rng, tL - tR);
+      if (window_length > 0) {
+        if (!local_shift()) return 0;
+        // The operator must stay between its neighbours in the block, which is a symmetric condition
+        if (tau_new == tR || !(tau_new - tR < tL - tR)) return 0;
+      } else
+        tau_new = tR + data.tau_seg.get_random_pt(rng, tL - tR);
 
     } else { // det_size = 1
 
       op_pos_in_det = 0;
       // Choose new random time, can be anywhere between beta and 0
-      tau_new = data.tau_seg.get_random_pt(rng);
+      if (window_length > 0) {
+        if (!local_shift()) return 0;
+      } else
+        tau_new = data.tau_seg.get_random_pt(rng);
     }
 
     // Record the length of the proposed shift
@@ -38,11 +38,14 @@ namespace triqs_cthyb {
     using det_type = det_manip::det_manip<qmc_data::delta_block_adaptor>;
     det_type::RollDirection roll_direction;
     int block_index;
+    double window_length; // Width of the local shift (0 : uniform between the neighbours in the block)
+    bool gaussian;        // Gaussian local shift, of standard deviation window_length, instead of uniform
 
     histogram *add_histo(std::string const &name, histo_map_t *histos);
+    bool local_shift();
 
     public:
-    move_shift_operator(qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos);
+    move_shift_operator(qmc_data &data, mc_tools::random_generator &rng, histo_map_t *histos, double window_length = 0, bool gaussian = false);
     mc_weight_t attempt();
     mc_weight_t accept();
     void reject();
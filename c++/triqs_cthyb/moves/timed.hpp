@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <triqs/mc_tools.hpp>
+#include "../qmc_data.hpp"
+
+#include <chrono>
+
+namespace triqs_cthyb {
+
+  // Statistics of a move
+  struct move_stats {
+    long n_attempted = 0;
+    long n_accepted  = 0;
+    double time      = 0; // Seconds spent in attempt, accept and reject
+  };
+
+  // Wraps a move, counting its attempts and acceptances and timing it
+  template <typename Move> class move_timed {
+
+    Move move;
+    move_stats *stats;
+    using clock = std::chrono::steady_clock;
+
+    double since(clock::time_point t0) const { return std::chrono::duration<double>(clock::now() - t0).count(); }
+
+    public:
+    move_timed(Move move, move_stats *stats) : move(std::move(move)), stats(stats) {}
+
+    mc_weight_t attempt() {
+      auto t0 = clock::now();
+      auto r  = move.attempt();
+      ++stats->n_attempted;
+      stats->time += since(t0);
+      return r;
+    }
+
+    mc_weight_t accept() {
+      auto t0 = clock::now();
+      auto r  = move.accept();
+      ++stats->n_accepted;
+      stats->time += since(t0);
+      return r;
+    }
+
+    void reject() {
+      auto t0 = clock::now();
+      move.reject();
+      stats->time += since(t0);
+    }
+  };
+}
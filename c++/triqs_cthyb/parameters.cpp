@@ -127,6 +127,50 @@ namespace triqs_cthyb {
     h5_write(grp, "move_global_prob", sp.move_global_prob);
 
     h5_write(grp, "imag_threshold", sp.imag_threshold);
+
+    h5_write(grp, "config_stream_file", sp.config_stream_file);
+    h5_write(grp, "config_stream_interval", sp.config_stream_interval);
+    h5_write(grp, "warm_start", sp.warm_start);
+    h5_write(grp, "det_check_interval", sp.det_check_interval);
+    h5_write(grp, "det_drift_tolerance", sp.det_drift_tolerance);
+    h5_write(grp, "det_block_threshold", sp.det_block_threshold);
+    h5_write(grp, "move_window_length", sp.move_window_length);
+    h5_write(grp, "move_window_prob", sp.move_window_prob);
+    h5_write(grp, "adaptive_warmup", sp.adaptive_warmup);
+    h5_write(grp, "adaptive_warmup_rounds", sp.adaptive_warmup_rounds);
+    h5_write(grp, "measure_move_timing", sp.measure_move_timing);
+    h5_write(grp, "move_global_woodbury_rank", sp.move_global_woodbury_rank);
+    h5_write(grp, "move_time_shift", sp.move_time_shift);
+    h5_write(grp, "move_time_reflection", sp.move_time_reflection);
+    h5_write(grp, "move_particle_hole", sp.move_particle_hole);
+    h5_write(grp, "move_importance", sp.move_importance);
+    h5_write(grp, "move_importance_prob", sp.move_importance_prob);
+    h5_write(grp, "move_importance_mixing", sp.move_importance_mixing);
+    h5_write(grp, "move_double_prune", sp.move_double_prune);
+    h5_write(grp, "move_shift_window", sp.move_shift_window);
+    h5_write(grp, "move_shift_gaussian", sp.move_shift_gaussian);
+    h5_write(grp, "move_pair_shift", sp.move_pair_shift);
+    h5_write(grp, "move_pair_shift_window", sp.move_pair_shift_window);
+    h5_write(grp, "move_flavour_change", sp.move_flavour_change);
+    h5_write(grp, "n_walkers", sp.n_walkers);
+    h5_write(grp, "results_on_all_ranks", sp.results_on_all_ranks);
+    h5_write(grp, "async_reduction", sp.async_reduction);
+    h5_write(grp, "load_balancing", sp.load_balancing);
+    h5_write(grp, "load_balancing_interval", sp.load_balancing_interval);
+    h5_write(grp, "checkpoint_file", sp.checkpoint_file);
+    h5_write(grp, "checkpoint_interval_cycles", sp.checkpoint_interval_cycles);
+    h5_write(grp, "checkpoint_interval_time", sp.checkpoint_interval_time);
+    h5_write(grp, "checkpoint_restart", sp.checkpoint_restart);
+    h5_write(grp, "replica_exchange_h_int_scales", sp.replica_exchange_h_int_scales);
+    h5_write(grp, "replica_exchange_interval", sp.replica_exchange_interval);
+    h5_write(grp, "replica_exchange_prob", sp.replica_exchange_prob);
+    h5_write(grp, "warmup_seed_ranks", sp.warmup_seed_ranks);
+    h5_write(grp, "warmup_seed_cycles", sp.warmup_seed_cycles);
+    h5_write(grp, "measure_G2_n_threads", sp.measure_G2_n_threads);
+    h5_write(grp, "measure_pipeline_depth", sp.measure_pipeline_depth);
+    h5_write(grp, "trace_rebuild_threads", sp.trace_rebuild_threads);
+    h5_write(grp, "move_transform_prob", sp.move_transform_prob);
+    h5_write(grp, "checkpoint_G2", sp.checkpoint_G2);
   }
 
   void h5_read(triqs::h5::group h5group, std::string name, solve_parameters_t &sp) {
@@ -179,6 +223,50 @@ namespace triqs_cthyb {
     h5_read(grp, "move_global_prob", sp.move_global_prob);
 
     h5_read(grp, "imag_threshold", sp.imag_threshold);
+
+    h5_read(grp, "config_stream_file", sp.config_stream_file);
+    h5_read(grp, "config_stream_interval", sp.config_stream_interval);
+    h5_read(grp, "warm_start", sp.warm_start);
+    h5_read(grp, "det_check_interval", sp.det_check_interval);
+    h5_read(grp, "det_drift_tolerance", sp.det_drift_tolerance);
+    h5_read(grp, "det_block_threshold", sp.det_block_threshold);
+    h5_read(grp, "move_window_length", sp.move_window_length);
+    h5_read(grp, "move_window_prob", sp.move_window_prob);
+    h5_read(grp, "adaptive_warmup", sp.adaptive_warmup);
+    h5_read(grp, "adaptive_warmup_rounds", sp.adaptive_warmup_rounds);
+    h5_read(grp, "measure_move_timing", sp.measure_move_timing);
+    h5_read(grp, "move_global_woodbury_rank", sp.move_global_woodbury_rank);
+    h5_read(grp, "move_time_shift", sp.move_time_shift);
+    h5_read(grp, "move_time_reflection", sp.move_time_reflection);
+    h5_read(grp, "move_particle_hole", sp.move_particle_hole);
+    h5_read(grp, "move_importance", sp.move_importance);
+    h5_read(grp, "move_importance_prob", sp.move_importance_prob);
+    h5_read(grp, "move_importance_mixing", sp.move_importance_mixing);
+    h5_read(grp, "move_double_prune", sp.move_double_prune);
+    h5_read(grp, "move_shift_window", sp.move_shift_window);
+    h5_read(grp, "move_shift_gaussian", sp.move_shift_gaussian);
+    h5_read(grp, "move_pair_shift", sp.move_pair_shift);
+    h5_read(grp, "move_pair_shift_window", sp.move_pair_shift_window);
+    h5_read(grp, "move_flavour_change", sp.move_flavour_change);
+    h5_read(grp, "n_walkers", sp.n_walkers);
+    h5_read(grp, "results_on_all_ranks", sp.results_on_all_ranks);
+    h5_read(grp, "async_reduction", sp.async_reduction);
+    h5_read(grp, "load_balancing", sp.load_balancing);
+    h5_read(grp, "load_balancing_interval", sp.load_balancing_interval);
+    h5_read(grp, "checkpoint_file", sp.checkpoint_file);
+    h5_read(grp, "checkpoint_interval_cycles", sp.checkpoint_interval_cycles);
+    h5_read(grp, "checkpoint_interval_time", sp.checkpoint_interval_time);
+    h5_read(grp, "checkpoint_restart", sp.checkpoint_restart);
+    h5_read(grp, "replica_exchange_h_int_scales", sp.replica_exchange_h_int_scales);
+    h5_read(grp, "replica_exchange_interval", sp.replica_exchange_interval);
+    h5_read(grp, "replica_exchange_prob", sp.replica_exchange_prob);
+    h5_read(grp, "warmup_seed_ranks", sp.warmup_seed_ranks);
+    h5_read(grp, "warmup_seed_cycles", sp.warmup_seed_cycles);
+    h5_read(grp, "measure_G2_n_threads", sp.measure_G2_n_threads);
+    h5_read(grp, "measure_pipeline_depth", sp.measure_pipeline_depth);
+    h5_read(grp, "trace_rebuild_threads", sp.trace_rebuild_threads);
+    h5_read(grp, "move_transform_prob", sp.move_transform_prob);
+    h5_read(grp, "checkpoint_G2", sp.checkpoint_G2);
   }
   
 } // namespace triqs_cthyb
@@ -186,6 +186,137 @@ namespace triqs_cthyb {
     /// Threshold below which imaginary components of Delta and h_loc are set to zero
     double imag_threshold = 1.e-15;
 
+    /// Write visited configurations to this binary stream file (the MPI rank is appended if there are several ranks)
+    /// type: str
+    /// default: "" = no stream
+    std::string config_stream_file = "";
+
+    /// Write every config_stream_interval-th Monte Carlo step to the configuration stream
+    int config_stream_interval = 100;
+
+    /// Start the Markov chain from the final configuration of the previous call to solve (on each MPI rank)?
+    bool warm_start = false;
+
+    /// Initial number of cycles between two recomputations of the determinants from scratch, adapted to the observed drift (0: fixed rate checks of det_manip)
+    int det_check_interval = 0;
+
+    /// Largest relative deviation of the updated inverse matrices from the recomputed ones before the check interval is reduced
+    double det_drift_tolerance = 1.e-8;
+
+    /// Split the determinants of a block into groups of orbitals coupled by h_loc or by elements of Delta(tau) larger than this threshold times its largest element (0: no splitting)
+    double det_block_threshold = 0.0;
+
+    /// Largest distance between the operators inserted and removed by the windowed moves (0: no windowed moves)
+    double move_window_length = 0.0;
+
+    /// Probability weight of each of the windowed insertion and removal moves, relative to the uniform ones (weight 1)
+    double move_window_prob = 1.0;
+
+    /// Tune the move weights, block proposal probabilities and window length during the first half of the warmup?
+    bool adaptive_warmup = false;
+
+    /// Number of rounds of the adaptive warmup, the move weights being updated after each round
+    int adaptive_warmup_rounds = 1;
+
+    /// Time the attempt, accept and reject steps of every move and report them in move_timing?
+    bool measure_move_timing = false;
+
+    /// Largest number of rows plus columns of a determinant replaced by a global move for which the ratio is computed by a low-rank update (0: always refill)
+    int move_global_woodbury_rank = 0;
+
+    /// Add to the global moves a shift of all operators by a random time (cyclically)
+    bool move_time_shift = false;
+
+    /// Add to the global moves the reflection tau -> beta - tau of all operators
+    bool move_time_reflection = false;
+
+    /// Add to the global moves the exchange of all creation and annihilation operators
+    bool move_particle_hole = false;
+
+    /// Add the insertion/removal of two operators with indices and time difference drawn according to |Delta_ab(tau)|
+    bool move_importance = false;
+
+    /// Probability of the importance sampled insertion/removal of two operators
+    double move_importance_prob = 1.0;
+
+    /// Fraction of the importance sampled proposals drawn uniformly
+    double move_importance_mixing = 0.1;
+
+    /// Restrict the proposals of the insertion/removal of four operators to the quadruples closing an atomic subspace, and drop the pairs of blocks without any
+    bool move_double_prune = false;
+
+    /// Width of the local shift of one operator around its time (0: uniform between the neighbouring operators of the block)
+    double move_shift_window = 0.0;
+
+    /// Draw the local shift from a Gaussian of standard deviation move_shift_window instead of uniformly in [-move_shift_window, move_shift_window]
+    bool move_shift_gaussian = false;
+
+    /// Add the rigid shift of a C, C^dagger pair of a block
+    bool move_pair_shift = false;
+
+    /// Largest shift of a C, C^dagger pair (0: beta / n, the mean distance between the n C^dagger of the block)
+    double move_pair_shift_window = 0.0;
+
+    /// Add the change of the inner indices of a C, C^dagger pair of a block, at fixed times
+    bool move_flavour_change = false;
+
+    /// Number of Markov chains of each MPI process, run on threads sharing the atomic problem and Delta
+    int n_walkers = 1;
+
+    /// Reduce the results to all MPI ranks. If false, they are only reduced to rank 0 and undefined on the other ranks
+    bool results_on_all_ranks = true;
+
+    /// Reduce the blocks of the two-particle Green's functions with non-blocking MPI calls, overlapped with their normalisation
+    bool async_reduction = false;
+
+    /// Share the n_cycles cycles of all ranks among the ranks according to their speed, so that they finish together
+    bool load_balancing = false;
+
+    /// Seconds between two exchanges of the progress of the ranks (load_balancing = True)
+    double load_balancing_interval = 1.0;
+
+    /// Write checkpoints of the accumulation to this HDF5 file (suffixed by the rank if more than one), empty for none
+    std::string checkpoint_file = "";
+
+    /// Measured cycles between two checkpoints, 0 for no limit
+    int checkpoint_interval_cycles = 0;
+
+    /// Seconds between two checkpoints, 0 for no limit
+    double checkpoint_interval_time = 600.0;
+
+    /// Continue from the checkpoints in checkpoint_file, if all ranks have one. The RNG state is not saved: a restart uses a new seed, it is not a continuation of the chain
+    bool checkpoint_restart = false;
+
+    /// Factors of h_int of the further replicas of the replica exchange, from the nearest to the target (1) on; empty for none
+    std::vector<double> replica_exchange_h_int_scales = std::vector<double>{};
+
+    /// Cycles of the further replicas between two exchanges
+    int replica_exchange_interval = 10;
+
+    /// Proposal probability of the exchange of configurations with the nearest replica
+    double replica_exchange_prob = 0.05;
+
+    /// Number of ranks which thermalise from the empty configuration and broadcast it to the other ranks, 0 for none
+    int warmup_seed_ranks = 0;
+
+    /// Warmup cycles of the other ranks from the configuration broadcast by their seed rank
+    int warmup_seed_cycles = 100;
+
+    /// Number of threads sharing the block pairs (and the NFFT of the blocks) of the two-particle measurements
+    int measure_G2_n_threads = 1;
+
+    /// Snapshots buffered for the two-particle measurements, which are then accumulated on a worker thread; 0 to accumulate them on the sampling thread
+    int measure_pipeline_depth = 0;
+
+    /// Threads sharing a full rebuild of the trace tree (warm starts, checkpoints, global moves); 1 for serial, at most the number of hardware threads
+    int trace_rebuild_threads = 1;
+
+    /// Overall probability of the time shift, time reflection and particle-hole moves, which cost a full refill of the dets and rebuild of the trace
+    double move_transform_prob = 0.005;
+
+    /// Also checkpoint the two-particle accumulators, copied at every checkpoint (else a restart only holds the G2 cycles measured since then)
+    bool checkpoint_G2 = true;
+
     solve_parameters_t() {}
 
     solve_parameters_t(many_body_op_t h_int, int n_cycles) : h_int(h_int), n_cycles(n_cycles) {}
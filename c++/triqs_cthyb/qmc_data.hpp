@@ -38,20 +38,22 @@ namespace triqs_cthyb {
     atom_diag const &h_diag;                     // Diagonalization of the atomic problem
     mutable impurity_trace imp_trace;            // Calculator of the trace
     std::vector<int> n_inner;
-    block_gf<imtime, delta_target_t> delta; // Hybridization function
+    std::shared_ptr<block_gf<imtime, delta_target_t> const> delta; // Hybridization function (shared by the walkers)
 
     /// This callable object adapts the Delta function for the call of the det.
     struct delta_block_adaptor {
-      gf<imtime, delta_target_t> delta_block; // make a copy. Needed in the real case anyway.
+      // make a copy, needed in the real case anyway. It is shared by the walkers of the process.
+      std::shared_ptr<gf<imtime, delta_target_t> const> delta_block;
 
-      delta_block_adaptor(gf<imtime, delta_target_t> delta_block) : delta_block(std::move(delta_block)) {}
+      delta_block_adaptor(gf<imtime, delta_target_t> delta_block)
+         : delta_block(std::make_shared<gf<imtime, delta_target_t> const>(std::move(delta_block))) {}
       delta_block_adaptor(delta_block_adaptor const &) = default;
       delta_block_adaptor(delta_block_adaptor &&)      = default;
       delta_block_adaptor &operator=(delta_block_adaptor const &) = delete;
       delta_block_adaptor &operator=(delta_block_adaptor &&) = default;
 
       det_scalar_t operator()(std::pair<time_pt, int> const &x, std::pair<time_pt, int> const &y) const {
-        det_scalar_t res = delta_block[closest_mesh_pt(double(x.first - y.first))](x.second, y.second);
+        det_scalar_t res = (*delta_block)[closest_mesh_pt(double(x.first - y.first))](x.second, y.second);
         return (x.first >= y.first ? res : -res); // x,y first are time_pt, wrapping is automatic in the - operation, but need to
                                                   // compute the sign
       }
@@ -70,7 +72,7 @@ namespace triqs_cthyb {
        : config(beta),
          tau_seg(beta),
          h_diag(h_diag),
-         delta(map([](gf_const_view<imtime> d) { return real(d); }, delta)),
+         delta(std::make_shared<block_gf<imtime, delta_target_t> const>(map([](gf_const_view<imtime> d) { return real(d); }, delta))),
          linindex(linindex),
          imp_trace(config, h_diag, p, histo_map),
          current_sign(1),
@@ -88,6 +90,25 @@ namespace triqs_cthyb {
       }
     }
 
+    // A further walker on the same problem, starting from the empty configuration. The atomic problem
+    // and the hybridization tables are shared with 'other', which must outlive this object.
+    qmc_data(qmc_data const &other, solve_parameters_t const &p, histo_map_t *histo_map) : qmc_data(other, other.h_diag, p, histo_map) {}
+
+    // A walker with the hybridization of 'other' and another local Hamiltonian (e.g. a replica with scaled interactions)
+    qmc_data(qmc_data const &other, atom_diag const &h_diag, solve_parameters_t const &p, histo_map_t *histo_map)
+       : config(other.config.beta()),
+         tau_seg(other.tau_seg),
+         linindex(other.linindex),
+         h_diag(h_diag),
+         imp_trace(config, h_diag, p, histo_map),
+         n_inner(other.n_inner),
+         delta(other.delta),
+         current_sign(1),
+         old_sign(1) {
+      std::tie(atomic_weight, atomic_reweighting) = imp_trace.compute();
+      for (auto const &det : other.dets) dets.emplace_back(det.get_function(), 100);
+    }
+
     qmc_data(qmc_data const &) = default;
     qmc_data &operator=(qmc_data const &) = delete;
 
@@ -124,6 +145,59 @@ namespace triqs_cthyb {
       old_sign     = current_sign;
       current_sign = (s % 2 == 0 ? 1 : -1);
     }
+
+    // The Monte Carlo sign (phase) of the current configuration
+    mc_weight_t mc_sign() const {
+      mc_weight_t w = current_sign * atomic_weight;
+      for (auto const &det : dets) w *= det.determinant();
+      return (std::abs(w) > 0 ? w / std::abs(w) : mc_weight_t(1));
+    }
+
+    // Replace the current configuration by ops, rebuilding the trace cache and the determinants.
+    // If ops does not fit the current problem or has a vanishing weight, the empty configuration is
+    // restored and false is returned.
+    bool load_configuration(config_snapshot_t const &ops) {
+
+      auto reset = [this]() {
+        config.clear();
+        imp_trace.rebuild();
+        for (auto &det : dets) det.clear();
+        std::tie(atomic_weight, atomic_reweighting) = imp_trace.compute();
+        current_sign = old_sign = 1;
+        return false;
+      };
+
+      config.clear();
+      std::vector<std::vector<std::pair<time_pt, int>>> x(dets.size()), y(dets.size());
+      for (auto const &[tau, op] : ops) {
+        auto it = linindex.find({op.block_index, op.inner_index});
+        if (it == linindex.end() || it->second != op.linear_index) return reset();
+        auto t = tau_seg.make_time_pt(tau);
+        config.insert(t, op);
+        // the snapshot is ordered from the largest time down, as the determinants
+        (op.dagger ? x : y)[op.block_index].emplace_back(t, op.inner_index);
+      }
+      if (config.size() != ops.size()) return reset(); // two operators at the same time
+
+      for (int b = 0; b < dets.size(); ++b) {
+        if (x[b].size() != y[b].size()) return reset();
+        if (x[b].empty()) {
+          dets[b].clear();
+          continue;
+        }
+        if (dets[b].try_refill(x[b], y[b]) == 0.0) {
+          dets[b].reject_last_try();
+          return reset();
+        }
+        dets[b].complete_operation();
+      }
+
+      imp_trace.rebuild();
+      std::tie(atomic_weight, atomic_reweighting) = imp_trace.compute();
+      if (atomic_weight == 0.0) return reset();
+      update_sign();
+      return true;
+    }
   };
 
   //--------- DEBUG ---------
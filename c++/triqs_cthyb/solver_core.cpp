@@ -22,24 +22,47 @@
  ******************************************************************************/
 #include "./solver_core.hpp"
 #include "./qmc_data.hpp"
+#include "./config_stream.hpp"
+#include "./det_drift.hpp"
+#include "./load_balance.hpp"
+#include "./warmup_seeds.hpp"
+#include "./checkpoint.hpp"
+#include "./det_blocks.hpp"
+#include "./move_tuning.hpp"
 
 #include <triqs/utility/callbacks.hpp>
 #include <triqs/utility/exceptions.hpp>
 #include <triqs/gfs.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <thread>
 #include <triqs/utility/variant.hpp>
 
 #include "./moves/insert.hpp"
 #include "./moves/remove.hpp"
 #include "./moves/double_insert.hpp"
 #include "./moves/double_remove.hpp"
+#include "./moves/importance_insert.hpp"
+#include "./moves/importance_remove.hpp"
 #include "./moves/shift.hpp"
+#include "./moves/pair_shift.hpp"
+#include "./moves/flavour_change.hpp"
 #include "./moves/global.hpp"
+#include "./moves/global_transform.hpp"
+#include "./moves/replica_exchange.hpp"
 #include "./measures/G_tau.hpp"
 #include "./measures/G_l.hpp"
 #include "./measures/perturbation_hist.hpp"
 #include "./measures/density_matrix.hpp"
 #include "./measures/average_sign.hpp"
+#include "./measures/walker_reduction.hpp"
+#include "./measures/pipeline.hpp"
 #ifdef CTHYB_G2_NFFT
 #include "./measures/G2_tau.hpp"
 #include "./measures/G2_iw.hpp"
@@ -55,6 +78,20 @@ namespace triqs_cthyb {
     void operator()(std::string s) { indices.push_back(s); }
   };
 
+  // Chains of a rank other than its main chain, which uses random_seed itself
+  enum class chain_kind : std::uint64_t { walker = 1, tuning, replica, restart };
+
+  // Seed of the index-th chain of a kind. (random_seed, kind, index) is mixed by the bijective splitmix64 finaliser,
+  // so that the seeds of different kinds, indices and ranks (random_seed depends on the rank) only collide by chance,
+  // unlike random_seed + index, and are uncorrelated with random_seed.
+  static int auxiliary_seed(int random_seed, chain_kind kind, int index) {
+    std::uint64_t z = (std::uint64_t(std::uint32_t(random_seed)) << 32) + (std::uint64_t(kind) << 24) + std::uint64_t(std::uint32_t(index));
+    z               = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z               = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z               = z ^ (z >> 31);
+    return int(z >> 33);
+  }
+
   solver_core::solver_core(constr_parameters_t const &p)
      : constr_parameters(p), beta(p.beta), gf_struct(p.gf_struct), n_iw(p.n_iw), n_tau(p.n_tau), n_l(p.n_l) {
 
@@ -209,129 +246,623 @@ namespace triqs_cthyb {
       return;
     }
 
-    // Initialise Monte Carlo quantities
-    qmc_data data(beta, params, h_diag, linindex, _Delta_tau, n_inner, histo_map);
-    auto qmc = mc_tools::mc_generic<mc_weight_t>(params.random_name, params.random_seed, 1.0, params.verbosity);
+    // Split the determinants along the (nearly) vanishing elements of Delta, keeping the orbitals coupled by h_loc together
+    auto det_blocks = (params.det_block_threshold > 0 ? make_det_block_structure(gf_struct, _Delta_tau, params.det_block_threshold, _h_loc)
+                                                      : make_det_block_structure(gf_struct));
+    block_gf<imtime> Delta_split;
+    if (det_blocks.is_split) {
+      if (params.measure_G2_tau || params.measure_G2_iw || params.measure_G2_iw_pp || params.measure_G2_iw_ph || params.measure_G2_iwll_pp
+          || params.measure_G2_iwll_ph)
+        TRIQS_RUNTIME_ERROR << "The two-particle Green's functions can not be measured with split determinant blocks (det_block_threshold > 0)";
+      linindex.clear();
+      n_inner.clear();
+      int d = 0;
+      for (auto const &bl : det_blocks.gf_struct) {
+        int inner_index = 0;
+        for (auto const &a : bl.second) linindex[{d, inner_index++}] = fops[{det_blocks.gf_block_name[d], a}];
+        n_inner.push_back(bl.second.size());
+        d++;
+      }
+      Delta_split = restrict_to_det_blocks<imtime, matrix_valued>(_Delta_tau, det_blocks);
+      if (params.verbosity >= 2) {
+        std::cout << "Determinant blocks:";
+        for (auto const &bl : det_blocks.gf_struct) std::cout << " " << bl.first << " (" << bl.second.size() << ")";
+        std::cout << std::endl;
+      }
+    }
+    block_gf_const_view<imtime> Delta_det = (det_blocks.is_split ? Delta_split : _Delta_tau);
+
+    // Checkpoints of the accumulation (one file per MPI rank), and restart from the last ones if all ranks have one
+    std::unique_ptr<solve_checkpoint> checkpoint;
+    bool restart = false;
+    if (!params.checkpoint_file.empty()) {
+      if (params.n_walkers > 1 || params.load_balancing) TRIQS_RUNTIME_ERROR << "Checkpoints require n_walkers = 1 and load_balancing = False";
+      auto filename = params.checkpoint_file + (_comm.size() > 1 ? "." + std::to_string(_comm.rank()) : "");
+      checkpoint    = std::make_unique<solve_checkpoint>(filename, params.checkpoint_interval_cycles, params.checkpoint_interval_time);
+      restart       = mpi_all_reduce(int(params.checkpoint_restart && checkpoint->available()), _comm, 0, MPI_MIN);
+      if (restart) checkpoint->load();
+    }
+
+    // Initialise Monte Carlo quantities. A restart is a new segment of the Markov chain, with its own seed.
+    qmc_data data(beta, params, h_diag, linindex, Delta_det, n_inner, histo_map);
+    auto qmc = mc_tools::mc_generic<mc_weight_t>(
+       params.random_name, (restart ? auxiliary_seed(params.random_seed, chain_kind::restart, checkpoint->n_restarts()) : params.random_seed), 1.0,
+       params.verbosity);
+
+    // Stream the visited configurations to disk (one file per MPI rank)
+    if (!params.config_stream_file.empty()) {
+      auto filename = params.config_stream_file + (_comm.size() > 1 ? "." + std::to_string(_comm.rank()) : "");
+      std::vector<std::pair<int, int>> lin_to_block_inner(fops.size());
+      for (auto const &[bl_in, lin] : linindex) lin_to_block_inner[lin] = bl_in;
+      data.config.attach_stream(std::make_shared<config_stream_writer>(filename, beta, lin_to_block_inner), params.config_stream_interval);
+    }
+
+    // Continue from the checkpoint, or start from the configuration left by the previous solve
+    if (restart) {
+      if (!data.load_configuration(checkpoint->configuration()))
+        TRIQS_RUNTIME_ERROR << "The configuration of the checkpoint does not fit the problem";
+      if (params.verbosity >= 2)
+        std::cout << "Restarting from a checkpoint with " << checkpoint->n_cycles() << " measured cycles" << std::endl;
+    } else if (params.warm_start && !_final_config.empty()) {
+      bool loaded = data.load_configuration(_final_config);
+      if (params.verbosity >= 2)
+        std::cout << (loaded ? "Warm start from a configuration with " + std::to_string(data.config.size()) + " operators"
+                             : std::string("Previous configuration does not fit the problem, starting from the empty configuration"))
+                  << std::endl;
+    }
 
     // --------------------------------------------------------------------------
     // Moves
     // --------------------------------------------------------------------------
 
     using move_set_type = mc_tools::move_set<mc_weight_t>;
-    move_set_type inserts(qmc.get_rng());
-    move_set_type removes(qmc.get_rng());
-    move_set_type double_inserts(qmc.get_rng());
-    move_set_type double_removes(qmc.get_rng());
+    using mc_type       = mc_tools::mc_generic<mc_weight_t>;
 
-    auto &delta_names  = _Delta_tau.block_names();
+    auto &delta_names  = Delta_det.block_names();
     auto get_prob_prop = [&params](std::string const &block_name) {
       auto f = params.proposal_prob.find(block_name);
       return (f != params.proposal_prob.end() ? f->second : 1.0);
     };
 
-    for (size_t block = 0; block < _Delta_tau.size(); ++block) {
-      int block_size         = _Delta_tau[block].data().shape()[1];
-      auto const &block_name = delta_names[block];
-      double prop_prob       = get_prob_prop(block_name);
-      inserts.add(move_insert_c_cdag(block, block_size, block_name, data, qmc.get_rng(), histo_map), "Insert Delta_" + block_name, prop_prob);
-      removes.add(move_remove_c_cdag(block, block_size, block_name, data, qmc.get_rng(), histo_map), "Remove Delta_" + block_name, prop_prob);
-      if (params.move_double) {
-        for (size_t block2 = 0; block2 < _Delta_tau.size(); ++block2) {
-          int block_size2         = _Delta_tau[block2].data().shape()[1];
-          auto const &block_name2 = delta_names[block2];
-          double prop_prob2       = get_prob_prop(block_name2);
-          double_inserts.add(
-             move_insert_c_c_cdag_cdag(block, block2, block_size, block_size2, block_name, block_name2, data, qmc.get_rng(), histo_map),
-             "Insert Delta_" + block_name + "_" + block_name2, prop_prob * prop_prob2);
-          double_removes.add(
-             move_remove_c_c_cdag_cdag(block, block2, block_size, block_size2, block_name, block_name2, data, qmc.get_rng(), histo_map),
-             "Remove Delta_" + block_name + "_" + block_name2, prop_prob * prop_prob2);
+    move_weights_t weights;
+    weights.window     = params.move_window_prob;
+    weights.global     = params.move_global_prob;
+    weights.importance = params.move_importance_prob;
+    if (params.move_window_length > 0) weights.window_lengths = {params.move_window_length};
+    for (size_t block = 0; block < Delta_det.size(); ++block) weights.block.push_back(get_prob_prop(det_blocks.gf_block_name[block]));
+
+    // Register the moves of the walker data in mc. If stats is given, every move is timed and counted in (*stats)[key].
+    auto add_moves = [&](mc_type &mc, qmc_data &data, move_weights_t const &w, histo_map_t *histos, move_stats_map_t *stats) {
+      auto add = [stats](auto &set, auto &&move, std::string const &name, double prob, std::string const &key) {
+        using move_t = std::decay_t<decltype(move)>;
+        if (stats)
+          set.add(move_timed<move_t>(std::move(move), &(*stats)[key]), name, prob);
+        else
+          set.add(std::move(move), name, prob);
+      };
+
+      int n_windows = w.window_lengths.size();
+      move_set_type inserts(mc.get_rng());
+      move_set_type removes(mc.get_rng());
+      move_set_type double_inserts(mc.get_rng());
+      move_set_type double_removes(mc.get_rng());
+      int n_double_pairs = 0;
+      move_set_type importance_inserts(mc.get_rng());
+      move_set_type importance_removes(mc.get_rng());
+      std::vector<move_set_type> window_inserts, window_removes;
+      window_inserts.reserve(n_windows);
+      window_removes.reserve(n_windows);
+      for (int k = 0; k < n_windows; ++k) {
+        window_inserts.emplace_back(mc.get_rng());
+        window_removes.emplace_back(mc.get_rng());
+      }
+
+      for (size_t block = 0; block < Delta_det.size(); ++block) {
+        int block_size         = Delta_det[block].data().shape()[1];
+        auto const &block_name = delta_names[block];
+        double prop_prob       = w.block[block];
+        add(inserts, move_insert_c_cdag(block, block_size, block_name, data, mc.get_rng(), histos), "Insert Delta_" + block_name, prop_prob,
+            move_stats_key("Insert", block_name));
+        add(removes, move_remove_c_cdag(block, block_size, block_name, data, mc.get_rng(), histos), "Remove Delta_" + block_name, prop_prob,
+            move_stats_key("Remove", block_name));
+        for (int k = 0; k < n_windows; ++k) {
+          add(window_inserts[k], move_insert_c_cdag(block, block_size, block_name, data, mc.get_rng(), histos, w.window_lengths[k]),
+              "Insert Delta_" + block_name + " (window)", prop_prob, move_stats_key("Insert", block_name, w.window_lengths[k]));
+          add(window_removes[k], move_remove_c_cdag(block, block_size, block_name, data, mc.get_rng(), histos, w.window_lengths[k]),
+              "Remove Delta_" + block_name + " (window)", prop_prob, move_stats_key("Remove", block_name, w.window_lengths[k]));
+        }
+        if (params.move_importance) {
+          auto table = std::make_shared<hyb_importance_table const>((*data.delta)[block], params.move_importance_mixing);
+          add(importance_inserts, move_insert_c_cdag_importance(block, table, data, mc.get_rng()), "Insert Delta_" + block_name + " (importance)",
+              prop_prob, move_stats_key("Insert", block_name, "importance"));
+          add(importance_removes, move_remove_c_cdag_importance(block, table, data, mc.get_rng()), "Remove Delta_" + block_name + " (importance)",
+              prop_prob, move_stats_key("Remove", block_name, "importance"));
+        }
+        if (params.move_double) {
+          for (size_t block2 = 0; block2 < Delta_det.size(); ++block2) {
+            int block_size2         = Delta_det[block2].data().shape()[1];
+            auto const &block_name2 = delta_names[block2];
+            double prop_prob2       = w.block[block2];
+            std::shared_ptr<double_move_filter const> filter;
+            if (params.move_double_prune) {
+              filter = std::make_shared<double_move_filter const>(data, block, block2);
+              if (!filter->any()) continue; // no quadruple of this pair of blocks is proposed
+            }
+            add(double_inserts,
+                move_insert_c_c_cdag_cdag(block, block2, block_size, block_size2, block_name, block_name2, data, mc.get_rng(), histos, filter),
+                "Insert Delta_" + block_name + "_" + block_name2, prop_prob * prop_prob2, "Insert four operators");
+            add(double_removes,
+                move_remove_c_c_cdag_cdag(block, block2, block_size, block_size2, block_name, block_name2, data, mc.get_rng(), histos, filter),
+                "Remove Delta_" + block_name + "_" + block_name2, prop_prob * prop_prob2, "Remove four operators");
+            ++n_double_pairs;
+          }
         }
       }
-    }
 
-    qmc.add_move(std::move(inserts), "Insert two operators", 1.0);
-    qmc.add_move(std::move(removes), "Remove two operators", 1.0);
-    if (params.move_double) {
-      qmc.add_move(std::move(double_inserts), "Insert four operators", 1.0);
-      qmc.add_move(std::move(double_removes), "Remove four operators", 1.0);
-    }
+      mc.add_move(std::move(inserts), "Insert two operators", w.pair);
+      mc.add_move(std::move(removes), "Remove two operators", w.pair);
+      for (int k = 0; k < n_windows; ++k) {
+        auto suffix = (n_windows == 1 ? std::string(" (window)") : " (window " + std::to_string(w.window_lengths[k]) + ")");
+        mc.add_move(std::move(window_inserts[k]), "Insert two operators" + suffix, w.window / n_windows);
+        mc.add_move(std::move(window_removes[k]), "Remove two operators" + suffix, w.window / n_windows);
+      }
+      if (params.move_importance) {
+        mc.add_move(std::move(importance_inserts), "Insert two operators (importance)", w.importance);
+        mc.add_move(std::move(importance_removes), "Remove two operators (importance)", w.importance);
+      }
+      if (n_double_pairs > 0) {
+        mc.add_move(std::move(double_inserts), "Insert four operators", w.double_pair);
+        mc.add_move(std::move(double_removes), "Remove four operators", w.double_pair);
+      }
+
+      if (params.move_shift) {
+        auto shift = move_shift_operator(data, mc.get_rng(), histos, params.move_shift_window, params.move_shift_gaussian);
+        if (stats)
+          mc.add_move(move_timed<move_shift_operator>(std::move(shift), &(*stats)["Shift one operator"]), "Shift one operator", w.shift);
+        else
+          mc.add_move(std::move(shift), "Shift one operator", w.shift);
+      }
+
+      // Rigid shifts and changes of the inner indices of C, C^dagger pairs, with the weight of the shifts
+      if (params.move_pair_shift) {
+        move_set_type pair_shifts(mc.get_rng());
+        for (size_t block = 0; block < Delta_det.size(); ++block)
+          add(pair_shifts, move_shift_pair(block, params.move_pair_shift_window, data, mc.get_rng()), "Shift pair Delta_" + delta_names[block],
+              w.block[block], "Shift two operators");
+        mc.add_move(std::move(pair_shifts), "Shift two operators", w.shift);
+      }
+      if (params.move_flavour_change) {
+        move_set_type flavour_changes(mc.get_rng());
+        int n_changes = 0;
+        for (size_t block = 0; block < Delta_det.size(); ++block) {
+          int block_size = Delta_det[block].data().shape()[1];
+          if (block_size < 2) continue; // a single flavour
+          add(flavour_changes, move_change_flavour_pair(block, block_size, data, mc.get_rng()), "Change flavours Delta_" + delta_names[block],
+              w.block[block], "Change flavours of two operators");
+          ++n_changes;
+        }
+        if (n_changes > 0) mc.add_move(std::move(flavour_changes), "Change flavours of two operators", w.shift);
+      }
+
+      if (params.move_global.size()) {
+        move_set_type global(mc.get_rng());
+        for (auto const &mv : params.move_global) {
+          auto const &name          = mv.first;
+          auto const &substitutions = mv.second;
+          add(global, move_global(name, substitutions, data, mc.get_rng(), params.move_global_woodbury_rank), name, 1.0, "Global moves");
+        }
+        mc.add_move(std::move(global), "Global moves", w.global);
+      }
 
-    if (params.move_shift) qmc.add_move(move_shift_operator(data, qmc.get_rng(), histo_map), "Shift one operator", 1.0);
+      // Each attempt refills all dets and rebuilds the trace (O(n^3)) : a small fixed probability, not tuned
+      if (params.move_time_shift || params.move_time_reflection || params.move_particle_hole) {
+        move_set_type transforms(mc.get_rng());
+        if (params.move_time_shift)
+          add(transforms, move_global_transform(global_transform_t::time_shift, data, mc.get_rng()), "Time shift", 1.0, "Global transformations");
+        if (params.move_time_reflection)
+          add(transforms, move_global_transform(global_transform_t::time_reflection, data, mc.get_rng()), "Time reflection", 1.0,
+              "Global transformations");
+        if (params.move_particle_hole)
+          add(transforms, move_global_transform(global_transform_t::particle_hole, data, mc.get_rng()), "Particle-hole", 1.0,
+              "Global transformations");
+        mc.add_move(std::move(transforms), "Global transformations", params.move_transform_prob);
+      }
+    };
+
+    // Adaptive warmup : the first half of the warmup is split into adaptive_warmup_rounds rounds.
+    // Each round tries all moves and several window lengths, starting with equal weights, and the
+    // weights maximizing the accepted moves per second are then used for the next round.
+    // The weights only change between the rounds and are frozen for the rest of the run.
+    int n_warmup_cycles = (restart ? 0 : params.n_warmup_cycles);
+    _tuned_move_weights.clear();
+
+    // A single clock bounds the whole sampling (tuning, shared warmup, warmup and accumulation of all walkers) by max_time
+    auto clock = triqs::utility::clock_callback(params.max_time);
+    if (params.adaptive_warmup && n_warmup_cycles > 1) {
+      std::vector<double> window_lengths;
+      for (int k = 2; k <= 6; ++k) window_lengths.push_back(beta / (1 << k));
+      if (params.move_window_length > 0) window_lengths.push_back(params.move_window_length);
+
+      auto tried = weights;
+      tried.pair = tried.window = tried.double_pair = tried.shift = tried.global = tried.importance = 1.0;
+
+      int n_rounds        = std::max(1, std::min(params.adaptive_warmup_rounds, n_warmup_cycles / 2));
+      int n_tuning_cycles = n_warmup_cycles / 2;
+      if (params.verbosity >= 2)
+        std::cout << "Tuning the moves during " << n_tuning_cycles << " warmup cycles in " << n_rounds << " round(s)" << std::endl;
+      for (int round = 0; round < n_rounds; ++round) {
+        tried.window_lengths = window_lengths;
+        move_stats_map_t stats;
+        mc_type tuning(params.random_name, auxiliary_seed(params.random_seed, chain_kind::tuning, round), 1.0, params.verbosity);
+        add_moves(tuning, data, tried, nullptr, &stats);
+        int n_round_cycles = n_tuning_cycles / n_rounds + (round < n_tuning_cycles % n_rounds ? 1 : 0);
+        tuning.warmup(n_round_cycles, params.length_cycle, clock, data.mc_sign());
+        mpi_sum_move_stats(stats, _comm);
+        tried = tune_move_weights(stats, tried, delta_names);
+      }
+      n_warmup_cycles -= n_tuning_cycles;
 
-    if (params.move_global.size()) {
-      move_set_type global(qmc.get_rng());
-      for (auto const &mv : params.move_global) {
-        auto const &name          = mv.first;
-        auto const &substitutions = mv.second;
-        global.add(move_global(name, substitutions, data, qmc.get_rng()), name, 1.0);
+      weights             = tried;
+      _tuned_move_weights = report_move_weights(weights, delta_names);
+      if (params.verbosity >= 2) {
+        std::cout << "Tuned move weights:" << std::endl;
+        for (auto const &[name, value] : _tuned_move_weights) std::cout << "  " << name << " = " << value << std::endl;
+      }
+    }
+
+    // Optionally time the moves of the run
+    move_stats_map_t move_timing_stats;
+    add_moves(qmc, data, weights, histo_map, params.measure_move_timing ? &move_timing_stats : nullptr);
+
+    // Replica exchange : further replicas of the problem with scaled interactions, whose Markov chains run on threads
+    // and exchange their configurations with their neighbours. Only the target replica (data, with h_int) is measured.
+    // The determinants travel with the configurations, so that every replica recomputes those it holds (det_drift).
+    struct replica_t {
+      atom_diag h_diag;
+      qmc_data data;
+      mc_type mc;
+      std::unique_ptr<det_drift_monitor> det_drift;
+
+      replica_t(atom_diag h, qmc_data const &target, solve_parameters_t const &p, int k)
+         : h_diag(std::move(h)),
+           data(target, h_diag, p, nullptr),
+           mc(p.random_name, auxiliary_seed(p.random_seed, chain_kind::replica, k), 1.0, 0) {}
+    };
+    std::vector<std::unique_ptr<replica_t>> replicas;
+    std::unique_ptr<replica_ladder> ladder;
+    if (!params.replica_exchange_h_int_scales.empty()) {
+      if (params.n_walkers > 1) TRIQS_RUNTIME_ERROR << "Replica exchange requires n_walkers = 1";
+      auto diagonalize = [&](many_body_op_t const &h) {
+        if (params.partition_method == "quantum_numbers") return atom_diag{h, fops, params.quantum_numbers};
+        if (params.partition_method == "none") return atom_diag{h, fops, std::vector<many_body_op_t>{}};
+        return atom_diag{h, fops};
+      };
+      std::vector<qmc_data *> ladder_data{&data};
+      for (int k = 1; k <= params.replica_exchange_h_int_scales.size(); ++k) {
+        auto h = _h_loc + (params.replica_exchange_h_int_scales[k - 1] - 1.0) * params.h_int;
+        auto &r = *replicas.emplace_back(std::make_unique<replica_t>(diagonalize(h), data, params, k));
+        add_moves(r.mc, r.data, weights, nullptr, nullptr);
+        if (params.det_check_interval > 0) {
+          r.det_drift = std::make_unique<det_drift_monitor>(r.data, params.det_check_interval, params.det_drift_tolerance);
+          r.mc.set_after_cycle_duty([&r]() { (*r.det_drift)(); });
+        }
+        ladder_data.push_back(&r.data);
       }
-      qmc.add_move(std::move(global), "Global moves", params.move_global_prob);
+      ladder = std::make_unique<replica_ladder>(ladder_data, [&replicas, &params](int k, std::atomic<bool> const &stop) {
+        auto &r = *replicas[k - 1];
+        r.mc.warmup(params.replica_exchange_interval, params.length_cycle, [&stop]() { return stop.load(); }, r.data.mc_sign());
+      });
+      qmc.add_move(move_replica_exchange(*ladder, qmc.get_rng()), "Replica exchange", params.replica_exchange_prob);
     }
 
     // --------------------------------------------------------------------------
     // Measurements
     // --------------------------------------------------------------------------
 
+    // The reductions of the results over the MPI ranks and the walkers of the process, given to the measures
+    rank_reduction ranks(_comm, params.results_on_all_ranks, params.async_reduction);
+    walker_reduction reduction(&ranks);
+
     // --------------------------------------------------------------------------
     // Two-particle correlators
 
     G2_measures_t G2_measures(_Delta_tau, gf_struct, params);
+    G2_measures.ranks = &ranks;
+
+    // Add a measure to mc, shared with the checkpoints if any
+    auto add_measure = [&checkpoint](mc_type &mc, auto &&m, std::string const &name) {
+      if (checkpoint)
+        mc.add_measure(checkpoint->add(name, std::move(m)), name);
+      else
+        mc.add_measure(std::move(m), name);
+    };
+
+    // Optionally, the two-particle measures read a shadow of data, filled with snapshots of the determinants,
+    // and are accumulated on a worker thread while the sampling goes on
+    std::optional<measure_pipeline> G2_pipeline;
+    if (params.measure_pipeline_depth > 0) {
+      if (checkpoint && params.checkpoint_G2)
+        TRIQS_RUNTIME_ERROR << "The pipelined two-particle measurements (measure_pipeline_depth > 0) can not be checkpointed, "
+                            << "set checkpoint_G2 = False";
+      G2_pipeline.emplace(data, params, params.measure_pipeline_depth);
+    }
+    qmc_data const &G2_data = (G2_pipeline ? G2_pipeline->shadow() : data);
+    if (G2_pipeline) G2_measures.dets = &G2_pipeline->dets();
+
+    // Copying the two-particle accumulators at every checkpoint doubles their memory : they are only checkpointed on demand
+    bool any_G2         = false;
+    auto add_G2_measure = [&](auto &&m, std::string const &name) {
+      any_G2 = true;
+      if (G2_pipeline)
+        G2_pipeline->add(std::move(m));
+      else if (params.checkpoint_G2)
+        add_measure(qmc, std::move(m), name);
+      else
+        qmc.add_measure(std::move(m), name);
+    };
 
 #ifdef CTHYB_G2_NFFT
     // Imaginary-time binning
-    if (params.measure_G2_tau) qmc.add_measure(measure_G2_tau{G2_tau, data, G2_measures}, "G2_tau imaginary-time measurement");
+    if (params.measure_G2_tau) add_G2_measure(measure_G2_tau{G2_tau, G2_data, G2_measures}, "G2_tau imaginary-time measurement");
 
     // NFFT Matsubara frequency measures
-    if (params.measure_G2_iw) qmc.add_measure(measure_G2_iw<G2_channel::AllFermionic>{G2_iw, data, G2_measures}, "G2_iw fermionic measurement");
+    if (params.measure_G2_iw)
+      add_G2_measure(measure_G2_iw<G2_channel::AllFermionic>{G2_iw, G2_data, G2_measures}, "G2_iw fermionic measurement");
     if (params.measure_G2_iw_pp)
-      qmc.add_measure(measure_G2_iw<G2_channel::PP>{G2_iw_pp, data, G2_measures}, "G2_iw_pp particle-particle measurement");
-    if (params.measure_G2_iw_ph) qmc.add_measure(measure_G2_iw<G2_channel::PH>{G2_iw_ph, data, G2_measures}, "G2_iw_ph particle-hole measurement");
+      add_G2_measure(measure_G2_iw<G2_channel::PP>{G2_iw_pp, G2_data, G2_measures}, "G2_iw_pp particle-particle measurement");
+    if (params.measure_G2_iw_ph)
+      add_G2_measure(measure_G2_iw<G2_channel::PH>{G2_iw_ph, G2_data, G2_measures}, "G2_iw_ph particle-hole measurement");
 
     // Legendre mixed basis measurements
     if (params.measure_G2_iwll_pp)
-      qmc.add_measure(measure_G2_iwll<G2_channel::PP>{G2_iwll_pp, data, G2_measures}, "G2_iwll_pp Legendre particle-particle measurement");
+      add_G2_measure(measure_G2_iwll<G2_channel::PP>{G2_iwll_pp, G2_data, G2_measures}, "G2_iwll_pp Legendre particle-particle measurement");
     if (params.measure_G2_iwll_ph)
-      qmc.add_measure(measure_G2_iwll<G2_channel::PH>{G2_iwll_ph, data, G2_measures}, "G2_iwll_ph Legendre particle-hole measurement");
+      add_G2_measure(measure_G2_iwll<G2_channel::PH>{G2_iwll_ph, G2_data, G2_measures}, "G2_iwll_ph Legendre particle-hole measurement");
 #endif
+    if (G2_pipeline && any_G2) qmc.add_measure(*G2_pipeline, "Two-particle measurements (pipelined)");
+    if (restart && any_G2 && !params.checkpoint_G2 && _comm.rank() == 0)
+      std::cerr << "Warning: restarting without checkpoint_G2, the two-particle Green's functions only hold the cycles measured from now on, "
+                << "unlike the other measurements" << std::endl;
 
     // --------------------------------------------------------------------------
     // Single-particle correlators
 
-    if (params.measure_G_tau) {
-      G_tau = block_gf<imtime>{{beta, Fermion, n_tau}, gf_struct};
-      qmc.add_measure(measure_G_tau{G_tau_accum, data, n_tau, gf_struct}, "G_tau measure");
+    // With split determinants, accumulate in the determinant blocks and scatter back at the end
+    std::optional<G_tau_G_target_t> G_tau_det_accum;
+    std::optional<G_l_t> G_l_det;
+
+    if (params.measure_density_matrix && !params.use_norm_as_weight)
+      TRIQS_RUNTIME_ERROR << "To measure the density_matrix of atomic states, you need to set "
+                             "use_norm_as_weight to True, i.e. to reweight the QMC";
+
+    // Register the measures of the walker data in mc, accumulating into the given results
+    auto add_measures = [&](mc_type &mc, qmc_data &data, std::optional<G_tau_G_target_t> &G_tau_acc, std::optional<G_l_t> &G_l_acc,
+                            histo_map_t &pert_order, histogram &pert_order_total, std::vector<matrix_t> &density_matrix, mc_weight_t &average_sign) {
+      if (params.measure_G_tau) add_measure(mc, measure_G_tau{G_tau_acc, data, n_tau, det_blocks.gf_struct, reduction}, "G_tau measure");
+
+      if (params.measure_G_l) add_measure(mc, measure_G_l{G_l_acc, data, n_l, det_blocks.gf_struct, reduction}, "G_l measure");
+
+      // Other measurements
+      if (params.measure_pert_order) {
+        auto &g_names = Delta_det.block_names();
+        for (size_t block = 0; block < Delta_det.size(); ++block) {
+          auto const &block_name = g_names[block];
+          add_measure(mc, measure_perturbation_hist(block, data, pert_order[block_name], reduction), "Perturbation order (" + block_name + ")");
+        }
+        add_measure(mc, measure_perturbation_hist_total(data, pert_order_total, reduction), "Perturbation order");
+      }
+      if (params.measure_density_matrix)
+        add_measure(mc, measure_density_matrix{data, density_matrix, reduction}, "Density Matrix for local static observable");
+
+      add_measure(mc, measure_average_sign{data, average_sign, reduction}, "Average sign");
+    };
+
+    if (params.measure_G_tau) G_tau = block_gf<imtime>{{beta, Fermion, n_tau}, gf_struct};
+    add_measures(qmc, data, det_blocks.is_split ? G_tau_det_accum : G_tau_accum, det_blocks.is_split ? G_l_det : G_l, _pert_order,
+                 _pert_order_total, _density_matrix, _average_sign);
+
+    // --------------------------------------------------------------------------
+
+    // Recompute the determinants at an interval adapted to their numerical drift
+    std::unique_ptr<det_drift_monitor> det_drift;
+    if (params.det_check_interval > 0) {
+      det_drift = std::make_unique<det_drift_monitor>(data, params.det_check_interval, params.det_drift_tolerance);
+      qmc.set_after_cycle_duty([&det_drift]() { (*det_drift)(); });
     }
 
-    if (params.measure_G_l) qmc.add_measure(measure_G_l{G_l, data, n_l, gf_struct}, "G_l measure");
+    // Further walkers (Markov chains) of this process, run on threads. They share the atomic problem and
+    // the Delta tables with data and have their own configuration, moves and accumulators, which are
+    // merged into those of the first walker before the MPI reduction. The two-particle measures, the
+    // configuration stream, the move timing and the performance analysis only run on the first walker.
+    struct walker_t {
+      qmc_data data;
+      mc_type mc;
+      std::optional<G_tau_G_target_t> G_tau;
+      std::optional<G_l_t> G_l;
+      histo_map_t pert_order;
+      histogram pert_order_total;
+      std::vector<matrix_t> density_matrix;
+      mc_weight_t average_sign;
+      std::unique_ptr<det_drift_monitor> det_drift;
+
+      walker_t(qmc_data const &first, solve_parameters_t const &p, int n)
+         : data(first, p, nullptr), mc(p.random_name, auxiliary_seed(p.random_seed, chain_kind::walker, n), 1.0, 0) {}
+    };
+    if (params.n_walkers < 1) TRIQS_RUNTIME_ERROR << "n_walkers must be at least 1";
+    std::vector<std::unique_ptr<walker_t>> walkers;
+    for (int n = 1; n < params.n_walkers; ++n) {
+      auto &w = *walkers.emplace_back(std::make_unique<walker_t>(data, params, n));
+      if (params.warm_start && !_final_config.empty()) w.data.load_configuration(_final_config);
+      add_moves(w.mc, w.data, weights, nullptr, nullptr);
+      add_measures(w.mc, w.data, w.G_tau, w.G_l, w.pert_order, w.pert_order_total, w.density_matrix, w.average_sign);
+      if (params.det_check_interval > 0) {
+        w.det_drift = std::make_unique<det_drift_monitor>(w.data, params.det_check_interval, params.det_drift_tolerance);
+        w.mc.set_after_cycle_duty([&w]() { (*w.det_drift)(); });
+      }
+    }
+
+    // With load balancing, the n_cycles cycles of every walker of every rank are shared among the ranks according to their speed
+    std::unique_ptr<cycle_balancer> balancer;
+    if (params.load_balancing)
+      balancer = std::make_unique<cycle_balancer>(_comm, long(params.n_cycles) * _comm.size() * params.n_walkers, params.load_balancing_interval);
+    int n_accumulation_cycles = (balancer ? std::numeric_limits<int>::max() : params.n_cycles - (restart ? checkpoint->n_cycles() : 0));
+    std::atomic<long> n_measured_cycles{0}; // by all walkers of the process, in this segment
+    std::atomic<bool> stop_walkers{false}, walker_failed{false}; // a failed walker stops the others and the first one
+    double accumulation_time = 0;
+
+    auto run_walker = [&](mc_type &mc, qmc_data &data, int n_warmup, std::function<bool()> stop, double *seconds) {
+      int status = mc.warmup(n_warmup, params.length_cycle, clock, data.mc_sign());
+      if (status != 0) return status;
+      auto start = std::chrono::steady_clock::now();
+      status     = mc.accumulate(n_accumulation_cycles, params.length_cycle, [&]() {
+        ++n_measured_cycles;
+        return clock() || stop();
+      });
+      if (seconds) *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return status;
+    };
 
-    // Other measurements
-    if (params.measure_pert_order) {
-      auto &g_names = _Delta_tau.block_names();
-      for (size_t block = 0; block < _Delta_tau.size(); ++block) {
-        auto const &block_name = g_names[block];
-        qmc.add_measure(measure_perturbation_hist(block, data, _pert_order[block_name]), "Perturbation order (" + block_name + ")");
+    // Shared warmup : only the seed ranks thermalise from the empty configuration. Each of them then broadcasts its
+    // configuration to its group of ranks, which decorrelate from it for warmup_seed_cycles cycles with their own RNG.
+    // On all ranks, the further walkers also start from this configuration and warm up for warmup_seed_cycles cycles.
+    // Without shared warmup, every walker thermalises from its own configuration for n_warmup_cycles cycles.
+    int n_walker_warmup_cycles = params.n_warmup_cycles;
+    if (params.warmup_seed_ranks > 0 && params.warmup_seed_ranks < _comm.size() && n_warmup_cycles > 0) {
+      warmup_seeds seeds(_comm, params.warmup_seed_ranks);
+      config_snapshot_t ops;
+      if (seeds.is_seed()) {
+        qmc.warmup(n_warmup_cycles, params.length_cycle, clock, data.mc_sign());
+        ops             = seeds.broadcast(data.config.snapshot());
+        n_warmup_cycles = 0;
+      } else {
+        ops = seeds.broadcast({});
+        if (!data.load_configuration(ops)) TRIQS_RUNTIME_ERROR << "The configuration handed out by the seed rank does not fit the problem";
+        n_warmup_cycles = params.warmup_seed_cycles;
+      }
+      for (auto &w : walkers)
+        if (!w->data.load_configuration(ops)) TRIQS_RUNTIME_ERROR << "The configuration handed out by the seed rank does not fit the problem";
+      n_walker_warmup_cycles = params.warmup_seed_cycles;
+      if (params.verbosity >= 2 && _comm.rank() == 0)
+        std::cout << "Shared warmup: " << params.warmup_seed_ranks << " seed rank(s) broadcast their configurations" << std::endl;
+    }
+
+    // Run! The empty (starting) configuration has sign = 1, a loaded or partially warmed up one carries its own sign
+    std::vector<std::exception_ptr> walker_errors(walkers.size());
+    std::vector<std::thread> walker_threads;
+    for (int k = 0; k < walkers.size(); ++k)
+      walker_threads.emplace_back([&, k]() {
+        auto &w = *walkers[k];
+        try {
+          run_walker(w.mc, w.data, n_walker_warmup_cycles, [&]() { return stop_walkers || walker_failed; }, nullptr);
+        } catch (...) {
+          walker_errors[k] = std::current_exception();
+          walker_failed    = true;
+        }
+      });
+    std::exception_ptr error;
+    try {
+      if (restart) checkpoint->restore_measures();
+      auto stop = [&]() {
+        if (walker_failed) return true; // its error is rethrown once the walkers are joined
+        if (checkpoint) (*checkpoint)((restart ? checkpoint->n_cycles() : 0) + n_measured_cycles, data.config);
+        return balancer && (*balancer)(n_measured_cycles);
+      };
+      _solve_status = (n_accumulation_cycles > 0 ? run_walker(qmc, data, n_warmup_cycles, stop, &accumulation_time) : 0);
+      if (balancer && !walker_failed) {
+        balancer->finish();
+        if (balancer->target_reached()) _solve_status = 0;
       }
-      qmc.add_measure(measure_perturbation_hist_total(data, _pert_order_total), "Perturbation order");
+    } catch (...) { error = std::current_exception(); }
+    if (balancer || error || walker_failed) stop_walkers = true;
+    for (auto &t : walker_threads) t.join();
+    try {
+      if (ladder) ladder->stop();
+    } catch (...) {
+      if (!error) error = std::current_exception();
     }
-    if (params.measure_density_matrix) {
-      if (!params.use_norm_as_weight)
-        TRIQS_RUNTIME_ERROR << "To measure the density_matrix of atomic states, you need to set "
-                               "use_norm_as_weight to True, i.e. to reweight the QMC";
-      qmc.add_measure(measure_density_matrix{data, _density_matrix}, "Density Matrix for local static observable");
+    for (auto &e : walker_errors)
+      if (!error) error = e;
+    if (error) std::rethrow_exception(error);
+
+    // All the cycles are measured on all ranks : a later solve must not restart from these checkpoints
+    if (checkpoint && mpi_all_reduce(_solve_status, _comm, 0, MPI_MAX) == 0) checkpoint->complete();
+
+    // Measured cycles and throughput of every rank
+    std::vector<double> rank_cycles(_comm.size()), rank_seconds(_comm.size()), rank_throughput(_comm.size());
+    rank_cycles[_comm.rank()]  = n_measured_cycles;
+    rank_seconds[_comm.rank()] = accumulation_time;
+    rank_cycles                = mpi_all_reduce(rank_cycles, _comm);
+    rank_seconds               = mpi_all_reduce(rank_seconds, _comm);
+    for (int r = 0; r < _comm.size(); ++r) rank_throughput[r] = (rank_seconds[r] > 0 ? rank_cycles[r] / rank_seconds[r] : 0);
+    _rank_statistics = {{"cycles", rank_cycles}, {"seconds", rank_seconds}, {"cycles_per_second", rank_throughput}};
+    if (params.verbosity >= 2 && balancer)
+      std::cout << "Load balancing: " << long(std::accumulate(rank_cycles.begin(), rank_cycles.end(), 0.0)) << " cycles measured in "
+                << balancer->n_exchanges() << " exchanges" << std::endl;
+
+    _replica_exchange_acceptance.clear();
+    if (ladder) {
+      std::vector<double> attempted(ladder->n_attempted().begin(), ladder->n_attempted().end());
+      std::vector<double> accepted(ladder->n_accepted().begin(), ladder->n_accepted().end());
+      attempted = mpi_all_reduce(attempted, _comm);
+      accepted  = mpi_all_reduce(accepted, _comm);
+      for (int k = 0; k < attempted.size(); ++k) _replica_exchange_acceptance.push_back(attempted[k] > 0 ? accepted[k] / attempted[k] : 0);
+      if (params.verbosity >= 2) {
+        std::cout << "Replica exchange acceptance rates:" << std::endl;
+        for (int k = 0; k < attempted.size(); ++k)
+          std::cout << "  " << (k == 0 ? 1.0 : params.replica_exchange_h_int_scales[k - 1]) << " <-> " << params.replica_exchange_h_int_scales[k]
+                    << " : " << _replica_exchange_acceptance[k] << " (" << long(attempted[k]) << " attempts)" << std::endl;
+      }
     }
 
-    qmc.add_measure(measure_average_sign{data, _average_sign}, "Average sign");
+    if (params.verbosity >= 2 && G2_pipeline && G2_pipeline->n_snapshots() > 0)
+      std::cout << "Pipelined two-particle measurements: " << G2_pipeline->n_snapshots() << " snapshots, " << G2_pipeline->n_synchronous()
+                << " measured synchronously" << std::endl;
+
+    // The results of the first walker are collected last, with those of all walkers of the process
+    for (auto &w : walkers) reduction.merge(w->mc, _comm);
+    reduction.finish(qmc, _comm);
+    _final_config = data.config.snapshot();
+
+    _move_timing.clear();
+    if (params.measure_move_timing) {
+      mpi_sum_move_stats(move_timing_stats, _comm);
+      _move_timing = move_timing_table(move_timing_stats);
+      if (params.verbosity >= 2) {
+        std::cout << "Move timing (attempts, accepted, seconds, seconds per attempt, summed over ranks):" << std::endl;
+        for (auto const &[name, t] : _move_timing)
+          std::cout << "  " << std::setw(40) << std::left << name << std::right << std::setw(14) << long(t[0]) << std::setw(14) << long(t[1])
+                    << std::setw(14) << t[2] << std::setw(14) << t[3] << std::endl;
+      }
+    }
 
-    // --------------------------------------------------------------------------
+    _det_drift_max = 0;
+    if (det_drift) {
+      det_drift->collect_results(_comm);
+      _det_drift_max = det_drift->max_drift();
+      for (auto &r : replicas) {
+        r->det_drift->collect_results(_comm);
+        _det_drift_max = std::max(_det_drift_max, r->det_drift->max_drift());
+      }
+      if (params.verbosity >= 2)
+        std::cout << "Determinant recomputations: " << det_drift->n_checks() << " (" << det_drift->n_over_tolerance()
+                  << " above tolerance), largest relative drift " << _det_drift_max << ", final interval "
+                  << det_drift->interval() << " cycles" << std::endl;
+    }
 
-    // Run! The empty (starting) configuration has sign = 1
-    _solve_status =
-       qmc.warmup_and_accumulate(params.n_warmup_cycles, params.n_cycles, params.length_cycle, triqs::utility::clock_callback(params.max_time));
-    qmc.collect_results(_comm);
+    // With results_on_all_ranks = False, the other ranks only hold partial sums : they are not post-processed there
+    if (!params.results_on_all_ranks && _comm.rank() != 0) return;
 
     if (params.verbosity >= 2) std::cout << "Average sign: " << _average_sign << std::endl;
 
+    if (G_tau_det_accum) {
+      G_tau_accum = G_tau_G_target_t{{beta, Fermion, n_tau}, gf_struct};
+      scatter_det_blocks<imtime, G_target_t>(*G_tau_accum, *G_tau_det_accum, det_blocks);
+    }
+    if (G_l_det) {
+      G_l = G_l_t{{beta, Fermion, static_cast<size_t>(n_l)}, gf_struct};
+      scatter_det_blocks<legendre, matrix_valued>(*G_l, *G_l_det, det_blocks);
+    }
+
     // Copy local (real or complex) G_tau back to complex G_tau
     if (G_tau && G_tau_accum) *G_tau = *G_tau_accum;
   }
@@ -29,6 +29,7 @@
 #include <triqs/atom_diag/functions.hpp>
 
 #include "types.hpp"
+#include "configuration.hpp"
 #include "container_set.hpp"
 #include "parameters.hpp"
 
@@ -43,13 +44,19 @@ namespace triqs_cthyb {
     many_body_op_t _h_loc; // The local Hamiltonian = h_int + h0
     int n_iw, n_tau, n_l;
 
-    histogram _pert_order_total;           // Histogram of the total perturbation order
-    histo_map_t _pert_order;               // Histograms of the perturbation order for each block
-    std::vector<matrix_t> _density_matrix; // density matrix, when used in Norm mode
-    triqs::mpi::communicator _comm;        // define the communicator, here MPI_COMM_WORLD
-    histo_map_t _performance_analysis;     // Histograms used for performance analysis
-    mc_weight_t _average_sign;             // average sign of the QMC
-    int _solve_status;                     // Status of the solve upon exit: 0 for clean termination, > 0 otherwise.
+    histogram _pert_order_total;                                 // Histogram of the total perturbation order
+    histo_map_t _pert_order;                                     // Histograms of the perturbation order for each block
+    std::vector<matrix_t> _density_matrix;                       // density matrix, when used in Norm mode
+    triqs::mpi::communicator _comm;                              // define the communicator, here MPI_COMM_WORLD
+    histo_map_t _performance_analysis;                           // Histograms used for performance analysis
+    mc_weight_t _average_sign;                                   // average sign of the QMC
+    int _solve_status;                                           // Status of the solve upon exit: 0 for clean termination, > 0 otherwise.
+    config_snapshot_t _final_config;                             // Configuration of this rank at the end of the last solve (for warm starts)
+    double _det_drift_max = 0;                                   // Largest relative drift of the determinant inverses found during the last solve
+    std::map<std::string, double> _tuned_move_weights;           // Move weights chosen by the adaptive warmup
+    std::map<std::string, std::vector<double>> _move_timing;     // Timing table of the moves
+    std::map<std::string, std::vector<double>> _rank_statistics; // Measured cycles and throughput of each rank
+    std::vector<double> _replica_exchange_acceptance;            // Acceptance rates of the exchanges between neighbouring replicas
 
     // Return reference to container_set
     container_set_t &result_set() { return static_cast<container_set_t &>(*this); }
@@ -132,6 +139,32 @@ namespace triqs_cthyb {
     /// Status of the ``solve()`` on exit.
     int solve_status() const { return _solve_status; }
 
+    /// Largest relative deviation of the updated inverse matrices from the recomputed ones (``det_check_interval > 0``).
+    double det_drift_max() const { return _det_drift_max; }
+
+    /// Move weights (and window length) chosen by the adaptive warmup of the last ``solve()``.
+    std::map<std::string, double> const &tuned_move_weights() const { return _tuned_move_weights; }
+
+    /// Timing of the moves of the last ``solve()`` (``measure_move_timing = True``), summed over the MPI ranks.
+    /// For each move : number of attempts, number of acceptances, time spent (seconds), time per attempt (seconds).
+    std::map<std::string, std::vector<double>> const &move_timing() const { return _move_timing; }
+
+    /// Measured cycles of each MPI rank (all its walkers) during the last ``solve()``, the duration of its accumulation
+    /// in seconds and its throughput in cycles per second. Keys : cycles, seconds, cycles_per_second.
+    std::map<std::string, std::vector<double>> const &rank_statistics() const { return _rank_statistics; }
+
+    /// Acceptance rates of the exchanges of configurations between the replicas k and k + 1 during the last ``solve()``
+    /// (0 is the target replica), over all MPI ranks. Empty without replica exchange.
+    std::vector<double> const &replica_exchange_acceptance() const { return _replica_exchange_acceptance; }
+
+    /// Monte Carlo configuration of this rank at the end of the last ``solve()``.
+    CPP2PY_IGNORE
+    config_snapshot_t const &final_configuration() const { return _final_config; }
+
+    /// Use a configuration as starting point of the next ``solve()`` with ``warm_start = True``.
+    CPP2PY_IGNORE
+    void set_initial_configuration(config_snapshot_t c) { _final_config = std::move(c); }
+
     static std::string hdf5_scheme() { return "CTHYB_SolverCore"; }
 
     // Function that writes the solver_core to hdf5 file
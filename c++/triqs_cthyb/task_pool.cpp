@@ -0,0 +1,98 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./task_pool.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+#include <utility>
+
+namespace triqs_cthyb {
+
+  task_pool::task_pool(int n_threads) {
+    if (n_threads < 1) TRIQS_RUNTIME_ERROR << "task_pool: the number of threads must be at least 1, not " << n_threads;
+    for (int k = 1; k < n_threads; ++k) workers.emplace_back([this]() { worker_loop(); });
+  }
+
+  task_pool::~task_pool() {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cv_start.notify_all();
+    for (auto &w : workers) w.join();
+  }
+
+  // ------------------------------------------------------------------
+
+  void task_pool::run(int n, std::function<void(int)> const &f) {
+    if (n <= 0) return;
+    if (workers.empty() || n == 1) {
+      for (int i = 0; i < n; ++i) f(i);
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      task    = &f;
+      n_tasks = n;
+      next    = 0;
+      n_done  = 0;
+      error   = nullptr;
+      ++generation;
+    }
+    cv_start.notify_all();
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [this]() { return n_done == n_tasks; });
+    task = nullptr;
+    if (error) std::rethrow_exception(std::exchange(error, nullptr));
+  }
+
+  void task_pool::run_tasks() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (next < n_tasks) {
+      int i = next++;
+      lock.unlock();
+      try {
+        (*task)(i);
+      } catch (...) {
+        lock.lock();
+        if (!error) error = std::current_exception();
+        lock.unlock();
+      }
+      lock.lock();
+      if (++n_done == n_tasks) cv_done.notify_all();
+    }
+  }
+
+  void task_pool::worker_loop() {
+    long seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_start.wait(lock, [&]() { return stop || generation != seen; });
+        if (stop) return;
+        seen = generation;
+      }
+      run_tasks();
+    }
+  }
+
+} // namespace triqs_cthyb
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   A fixed set of worker threads running independent tasks
+
+   run(n, f) calls f(0), ..., f(n - 1) on the workers and on the calling
+   thread, and returns when all calls are done. The tasks are handed out one
+   at a time, so that tasks of different costs are balanced. The first
+   exception thrown by a task is rethrown by run.
+   ********************************************/
+
+  class task_pool {
+
+    public:
+    /// n_threads counts the calling thread : n_threads - 1 workers are started
+    task_pool(int n_threads);
+    ~task_pool();
+
+    task_pool(task_pool const &) = delete;
+    task_pool &operator=(task_pool const &) = delete;
+
+    int n_threads() const { return workers.size() + 1; }
+
+    void run(int n_tasks, std::function<void(int)> const &f);
+
+    private:
+    void worker_loop();
+    void run_tasks(); // take tasks until there is none left
+
+    std::function<void(int)> const *task = nullptr;
+    int n_tasks = 0, next = 0, n_done = 0;
+    long generation = 0; // incremented by every run
+    bool stop       = false;
+    std::exception_ptr error;
+    std::mutex mtx;
+    std::condition_variable cv_start, cv_done;
+    std::vector<std::thread> workers;
+  };
+
+} // namespace triqs_cthyb
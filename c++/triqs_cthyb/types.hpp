@@ -67,6 +67,10 @@ namespace triqs_cthyb {
 
   enum class G2_channel { PP, PH, AllFermionic }; // G2 sampling channels
 
+  /// The type holding a copy of an object of type T (the regular type of views)
+  template <typename T, typename = void> struct regular_type_of { using type = T; };
+  template <typename T> struct regular_type_of<T, std::void_t<typename T::regular_type>> { using type = typename T::regular_type; };
+
   /// Order of block indices for Block2Gf objects
   enum class block_order { AABB, ABBA };
   
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#include "./warmup_seeds.hpp"
+
+#include <triqs/utility/exceptions.hpp>
+
+namespace triqs_cthyb {
+
+  // Each operator travels as 5 doubles : tau, block_index, inner_index, dagger, linear_index
+
+  warmup_seeds::warmup_seeds(triqs::mpi::communicator const &c, int n_seeds) : rank(c.rank()), n_seeds(n_seeds) {
+    if (n_seeds < 1 || n_seeds > c.size()) TRIQS_RUNTIME_ERROR << "warmup_seeds: the number of seed ranks must be in [1, " << c.size() << "]";
+    // Ordered by rank, the seed rank is the root (0) of its group
+    MPI_Comm_split(c.get(), rank % n_seeds, rank, &group);
+  }
+
+  warmup_seeds::~warmup_seeds() { MPI_Comm_free(&group); }
+
+  // ------------------------------------------------------------------
+
+  config_snapshot_t warmup_seeds::broadcast(config_snapshot_t const &ops) {
+    std::vector<double> buf;
+    if (is_seed()) {
+      buf.reserve(5 * ops.size());
+      for (auto const &[tau, op] : ops)
+        buf.insert(buf.end(), {tau, double(op.block_index), double(op.inner_index), double(op.dagger), double(op.linear_index)});
+    }
+    long count = buf.size();
+    MPI_Bcast(&count, 1, MPI_LONG, 0, group);
+    buf.resize(count);
+    MPI_Bcast(buf.data(), count, MPI_DOUBLE, 0, group);
+    if (is_seed()) return ops;
+
+    config_snapshot_t received;
+    received.reserve(count / 5);
+    for (long i = 0; i + 4 < count; i += 5)
+      received.emplace_back(buf[i], op_desc{int(buf[i + 1]), int(buf[i + 2]), buf[i + 3] != 0, long(buf[i + 4])});
+    return received;
+  }
+
+} // namespace triqs_cthyb
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ *
+ * TRIQS: a Toolbox for Research in Interacting Quantum Systems
+ *
+ * Copyright (C) 2014, P. Seth, I. Krivenko, M. Ferrero and O. Parcollet
+ *
+ * TRIQS is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * TRIQS. If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#pragma once
+#include "./configuration.hpp"
+#include <triqs/mpi/base.hpp>
+
+#include <vector>
+
+namespace triqs_cthyb {
+
+  /********************************************
+   Shared warmup of the MPI ranks
+
+   Only the first n_seeds ranks thermalise from the empty configuration. The
+   ranks are split into n_seeds groups (rank % n_seeds), and each seed rank
+   broadcasts its thermalised configuration to its group at once. The other
+   ranks of the group start from it with a short warmup of their own, which
+   decorrelates them through their own random number generators.
+   ********************************************/
+
+  class warmup_seeds {
+
+    public:
+    warmup_seeds(triqs::mpi::communicator const &c, int n_seeds);
+    ~warmup_seeds();
+
+    warmup_seeds(warmup_seeds const &) = delete;
+    warmup_seeds &operator=(warmup_seeds const &) = delete;
+
+    /// Does this rank thermalise from the empty configuration?
+    bool is_seed() const { return rank < n_seeds; }
+
+    /// Broadcast the configuration of the seed rank (ops, ignored elsewhere) to its group, and return it on every rank
+    config_snapshot_t broadcast(config_snapshot_t const &ops);
+
+    private:
+    MPI_Comm group;
+    int rank, n_seeds;
+  };
+
+} // namespace triqs_cthyb
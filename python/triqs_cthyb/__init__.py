@@ -26,6 +26,8 @@ DOC
 from solver import Solver
 from solver_core import SolverCore
 from util import estimate_nfft_buf_size
+from config_stream import ConfigStream, read_config_stream
 
 __all__ = ['Solver', 'SolverCore',
-           'estimate_nfft_buf_size']
+           'estimate_nfft_buf_size',
+           'ConfigStream', 'read_config_stream']
@@ -0,0 +1,102 @@
+################################################################################
+#
+# TRIQS: a Toolbox for Research in Interacting Quantum Systems
+#
+# Copyright (C) 2014 by P. Seth, I. Krivenko, M. Ferrero, O. Parcollet
+#
+# TRIQS is free software: you can redistribute it and/or modify it under the
+# terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# TRIQS is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# TRIQS. If not, see <http://www.gnu.org/licenses/>.
+#
+################################################################################
+
+r"""
+Reader for the binary configuration streams written by the solver
+when the ``config_stream_file`` solve parameter is set.
+"""
+
+import struct
+import numpy as np
+
+_magic = b'CTHYBCS1'
+_version = 1
+_tau_max = 2**52
+
+op_dtype = np.dtype([('tau', np.float64), ('block', np.int32), ('inner', np.int32), ('dagger', np.bool_)])
+
+class ConfigStream(object):
+    r"""
+    Iterate over the configurations stored in a configuration stream.
+
+    Each item is a pair ``(step, ops)`` where ``step`` is the Monte Carlo step
+    at which the configuration was visited and ``ops`` is a structured
+    numpy array with fields ``tau``, ``block``, ``inner`` and ``dagger``,
+    ordered from the largest time down.
+
+    Parameters
+    ----------
+    filename : str
+        Name of the stream file.
+    """
+
+    def __init__(self, filename):
+        with open(filename, 'rb') as f:
+            self._data = f.read()
+        if self._data[:8] != _magic:
+            raise RuntimeError("%s is not a configuration stream file" % filename)
+        version, self.beta, n_lin = struct.unpack_from('<IdI', self._data, 8)
+        if version != _version:
+            raise RuntimeError("Unsupported configuration stream version %i" % version)
+        self.lin_to_block_inner = np.frombuffer(self._data, dtype='<i4', count=2*n_lin, offset=24).reshape(n_lin, 2)
+        self._start = 24 + 8 * n_lin
+
+    def _varint(self, pos):
+        data, x, shift = self._data, 0, 0
+        while True:
+            c = ord(data[pos:pos+1])
+            x |= (c & 0x7f) << shift
+            pos += 1
+            if not c & 0x80: return x, pos
+            shift += 7
+
+    def __iter__(self):
+        pos, step, end = self._start, 0, len(self._data)
+        while pos < end:
+            d_step, pos = self._varint(pos)
+            n_ops, pos = self._varint(pos)
+            step += d_step
+            ops = np.zeros(n_ops, dtype=op_dtype)
+            q = _tau_max
+            for n in range(n_ops):
+                dq, pos = self._varint(pos)
+                packed, pos = self._varint(pos)
+                q -= dq
+                ops[n] = (float(q) / _tau_max * self.beta,) + tuple(self.lin_to_block_inner[packed >> 1]) + (bool(packed & 1),)
+            yield step, ops
+
+def read_config_stream(filename):
+    r"""
+    Read all configurations of a configuration stream.
+
+    Returns
+    -------
+    steps : numpy array
+        Monte Carlo steps at which the configurations were visited.
+    configs : list of numpy arrays
+        The configurations, see :class:`ConfigStream`.
+    """
+    stream = ConfigStream(filename)
+    steps, configs = [], []
+    for step, ops in stream:
+        steps.append(step)
+        configs.append(ops)
+    return np.array(steps), configs
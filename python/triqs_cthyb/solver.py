@@ -131,7 +131,9 @@ class Solver(SolverCore):
 
         # Post-processing:
         # (only supported for G_tau, to permit compatibility with dft_tools)
-        if perform_post_proc and (self.last_solve_parameters["measure_G_tau"] == True):
+        # (only on the ranks holding the results, see results_on_all_ranks)
+        has_results = self.last_solve_parameters["results_on_all_ranks"] or mpi.is_master_node()
+        if perform_post_proc and has_results and (self.last_solve_parameters["measure_G_tau"] == True):
             # Fourier transform G_tau to obtain G_iw
             for name, g in self.G_tau:
                 bl_size = g.target_shape[0]
@@ -182,6 +182,92 @@ c.add_method("""void solve (**triqs_cthyb::solve_parameters_t)""",
 +-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
 | imag_threshold                | double                                         | 1.e-15                                           | Threshold below which imaginary components of Delta and h_loc are set to zero                                                                                                   |
 +-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| config_stream_file            | std::string                                    | ""                                               | Write visited configurations to this binary stream file (the MPI rank is appended if there are several ranks)\n     type: str\n     default: "" = no stream                     |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| config_stream_interval        | int                                            | 100                                              | Write every config_stream_interval-th Monte Carlo step to the configuration stream                                                                                              |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| warm_start                    | bool                                           | false                                            | Start the Markov chain from the final configuration of the previous call to solve (on each MPI rank)?                                                                           |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| det_check_interval            | int                                            | 0                                                | Initial number of cycles between two recomputations of the determinants from scratch, adapted to the observed drift (0: fixed rate checks of det_manip)                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| det_drift_tolerance           | double                                         | 1.e-8                                            | Largest relative deviation of the updated inverse matrices from the recomputed ones before the check interval is reduced                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| det_block_threshold           | double                                         | 0.0                                              | Split the determinants of a block into groups of orbitals coupled by h_loc or by elements of Delta(tau) larger than this threshold times its largest element (0: no splitting)  |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_window_length            | double                                         | 0.0                                              | Largest distance between the operators inserted and removed by the windowed moves (0: no windowed moves)                                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_window_prob              | double                                         | 1.0                                              | Probability weight of each of the windowed insertion and removal moves, relative to the uniform ones (weight 1)                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| adaptive_warmup               | bool                                           | false                                            | Tune the move weights, block proposal probabilities and window length during the first half of the warmup?                                                                      |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| adaptive_warmup_rounds        | int                                            | 1                                                | Number of rounds of the adaptive warmup, the move weights being updated after each round                                                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| measure_move_timing           | bool                                           | false                                            | Time the attempt, accept and reject steps of every move and report them in move_timing?                                                                                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_global_woodbury_rank     | int                                            | 0                                                | Largest number of rows plus columns of a determinant replaced by a global move for which the ratio is computed by a low-rank update (0: always refill)                          |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_time_shift               | bool                                           | false                                            | Add to the global moves a shift of all operators by a random time (cyclically)                                                                                                  |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_time_reflection          | bool                                           | false                                            | Add to the global moves the reflection tau -> beta - tau of all operators                                                                                                       |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_particle_hole            | bool                                           | false                                            | Add to the global moves the exchange of all creation and annihilation operators                                                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_importance               | bool                                           | false                                            | Add the insertion/removal of two operators with indices and time difference drawn according to |Delta_ab(tau)|                                                                  |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_importance_prob          | double                                         | 1.0                                              | Probability of the importance sampled insertion/removal of two operators                                                                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_importance_mixing        | double                                         | 0.1                                              | Fraction of the importance sampled proposals drawn uniformly                                                                                                                    |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_double_prune             | bool                                           | false                                            | Restrict the proposals of the insertion/removal of four operators to the quadruples closing an atomic subspace, and drop the pairs of blocks without any                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_shift_window             | double                                         | 0.0                                              | Width of the local shift of one operator around its time (0: uniform between the neighbouring operators of the block)                                                           |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_shift_gaussian           | bool                                           | false                                            | Draw the local shift from a Gaussian of standard deviation move_shift_window instead of uniformly in [-move_shift_window, move_shift_window]                                    |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_pair_shift               | bool                                           | false                                            | Add the rigid shift of a C, C^dagger pair of a block                                                                                                                            |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_pair_shift_window        | double                                         | 0.0                                              | Largest shift of a C, C^dagger pair (0: beta / n, the mean distance between the n C^dagger of the block)                                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_flavour_change           | bool                                           | false                                            | Add the change of the inner indices of a C, C^dagger pair of a block, at fixed times                                                                                            |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| n_walkers                     | int                                            | 1                                                | Number of Markov chains of each MPI process, run on threads sharing the atomic problem and Delta                                                                                |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| results_on_all_ranks          | bool                                           | true                                             | Reduce the results to all MPI ranks. If false, they are only reduced to rank 0 and undefined on the other ranks                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| async_reduction               | bool                                           | false                                            | Reduce the blocks of the two-particle Green's functions with non-blocking MPI calls, overlapped with their normalisation                                                        |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| load_balancing                | bool                                           | false                                            | Share the n_cycles cycles of all ranks among the ranks according to their speed, so that they finish together                                                                   |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| load_balancing_interval       | double                                         | 1.0                                              | Seconds between two exchanges of the progress of the ranks (load_balancing = True)                                                                                              |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| checkpoint_file               | std::string                                    | ""                                               | Write checkpoints of the accumulation to this HDF5 file (suffixed by the rank if more than one), empty for none                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| checkpoint_interval_cycles    | int                                            | 0                                                | Measured cycles between two checkpoints, 0 for no limit                                                                                                                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| checkpoint_interval_time      | double                                         | 600.0                                            | Seconds between two checkpoints, 0 for no limit                                                                                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| checkpoint_restart            | bool                                           | false                                            | Continue from the checkpoints in checkpoint_file, if all ranks have one. The RNG state is not saved: a restart uses a new seed, it is not a continuation of the chain           |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| replica_exchange_h_int_scales | std::vector<double>                            | std::vector<double>{}                            | Factors of h_int of the further replicas of the replica exchange, from the nearest to the target (1) on; empty for none                                                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| replica_exchange_interval     | int                                            | 10                                               | Cycles of the further replicas between two exchanges                                                                                                                            |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| replica_exchange_prob         | double                                         | 0.05                                             | Proposal probability of the exchange of configurations with the nearest replica                                                                                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| warmup_seed_ranks             | int                                            | 0                                                | Number of ranks which thermalise from the empty configuration and broadcast it to the other ranks, 0 for none                                                                   |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| warmup_seed_cycles            | int                                            | 100                                              | Warmup cycles of the other ranks from the configuration broadcast by their seed rank                                                                                            |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| measure_G2_n_threads          | int                                            | 1                                                | Number of threads sharing the block pairs (and the NFFT of the blocks) of the two-particle measurements                                                                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| measure_pipeline_depth        | int                                            | 0                                                | Snapshots buffered for the two-particle measurements, which are then accumulated on a worker thread; 0 to accumulate them on the sampling thread                                |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| trace_rebuild_threads         | int                                            | 1                                                | Threads sharing a full rebuild of the trace tree (warm starts, checkpoints, global moves); 1 for serial, at most the number of hardware threads                                 |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| move_transform_prob           | double                                         | 0.005                                            | Overall probability of the time shift, time reflection and particle-hole moves, which cost a full refill of the dets and rebuild of the trace                                   |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
+| checkpoint_G2                 | bool                                           | true                                             | Also checkpoint the two-particle accumulators, copied at every checkpoint (else a restart only holds the G2 cycles measured since then)                                         |
++-------------------------------+------------------------------------------------+--------------------------------------------------+---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------+
 """)
 
 c.add_method("""std::string hdf5_scheme ()""",
@@ -240,6 +326,26 @@ c.add_property(name = "solve_status",
                getter = cfunction("int solve_status ()"),
                doc = """Status of the ``solve()`` on exit.""")
 
+c.add_property(name = "tuned_move_weights",
+               getter = cfunction("std::map<std::string,double> tuned_move_weights ()"),
+               doc = """Move weights (and window length) chosen by the adaptive warmup of the last ``solve()``.""")
+
+c.add_property(name = "move_timing",
+               getter = cfunction("std::map<std::string,std::vector<double>> move_timing ()"),
+               doc = """Timing of the moves of the last ``solve()`` (``measure_move_timing = True``), summed over the MPI ranks.\n For each move : number of attempts, number of acceptances, time spent (seconds), time per attempt (seconds).""")
+
+c.add_property(name = "rank_statistics",
+               getter = cfunction("std::map<std::string,std::vector<double>> rank_statistics ()"),
+               doc = """Measured cycles of each MPI rank (all its walkers) during the last ``solve()``, the duration of its accumulation\n in seconds and its throughput in cycles per second. Keys : cycles, seconds, cycles_per_second.""")
+
+c.add_property(name = "replica_exchange_acceptance",
+               getter = cfunction("std::vector<double> replica_exchange_acceptance ()"),
+               doc = """Acceptance rates of the exchanges of configurations between the replicas k and k + 1 during the last ``solve()``\n (0 is the target replica), over all MPI ranks. Empty without replica exchange.""")
+
+c.add_property(name = "det_drift_max",
+               getter = cfunction("double det_drift_max ()"),
+               doc = """Largest relative deviation of the updated inverse matrices from the recomputed ones (``det_check_interval > 0``).""")
+
 module.add_class(c)
 
 
@@ -433,6 +539,221 @@ c.add_member(c_name = "imag_threshold",
              initializer = """ 1.e-15 """,
              doc = """Threshold below which imaginary components of Delta and h_loc are set to zero""")
 
+c.add_member(c_name = "config_stream_file",
+             c_type = "std::string",
+             initializer = """ "" """,
+             doc = """Write visited configurations to this binary stream file (the MPI rank is appended if there are several ranks)\n     type: str\n     default: "" = no stream""")
+
+c.add_member(c_name = "config_stream_interval",
+             c_type = "int",
+             initializer = """ 100 """,
+             doc = """Write every config_stream_interval-th Monte Carlo step to the configuration stream""")
+
+c.add_member(c_name = "warm_start",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Start the Markov chain from the final configuration of the previous call to solve (on each MPI rank)?""")
+
+c.add_member(c_name = "det_check_interval",
+             c_type = "int",
+             initializer = """ 0 """,
+             doc = """Initial number of cycles between two recomputations of the determinants from scratch, adapted to the observed drift (0: fixed rate checks of det_manip)""")
+
+c.add_member(c_name = "det_drift_tolerance",
+             c_type = "double",
+             initializer = """ 1.e-8 """,
+             doc = """Largest relative deviation of the updated inverse matrices from the recomputed ones before the check interval is reduced""")
+
+c.add_member(c_name = "det_block_threshold",
+             c_type = "double",
+             initializer = """ 0.0 """,
+             doc = """Split the determinants of a block into groups of orbitals coupled by h_loc or by elements of Delta(tau) larger than this threshold times its largest element (0: no splitting)""")
+
+c.add_member(c_name = "move_window_length",
+             c_type = "double",
+             initializer = """ 0.0 """,
+             doc = """Largest distance between the operators inserted and removed by the windowed moves (0: no windowed moves)""")
+
+c.add_member(c_name = "move_window_prob",
+             c_type = "double",
+             initializer = """ 1.0 """,
+             doc = """Probability weight of each of the windowed insertion and removal moves, relative to the uniform ones (weight 1)""")
+
+c.add_member(c_name = "adaptive_warmup",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Tune the move weights, block proposal probabilities and window length during the first half of the warmup?""")
+
+c.add_member(c_name = "adaptive_warmup_rounds",
+             c_type = "int",
+             initializer = """ 1 """,
+             doc = """Number of rounds of the adaptive warmup, the move weights being updated after each round""")
+
+c.add_member(c_name = "measure_move_timing",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Time the attempt, accept and reject steps of every move and report them in move_timing?""")
+
+c.add_member(c_name = "move_global_woodbury_rank",
+             c_type = "int",
+             initializer = """ 0 """,
+             doc = """Largest number of rows plus columns of a determinant replaced by a global move for which the ratio is computed by a low-rank update (0: always refill)""")
+
+c.add_member(c_name = "move_time_shift",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add to the global moves a shift of all operators by a random time (cyclically)""")
+
+c.add_member(c_name = "move_time_reflection",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add to the global moves the reflection tau -> beta - tau of all operators""")
+
+c.add_member(c_name = "move_particle_hole",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add to the global moves the exchange of all creation and annihilation operators""")
+
+c.add_member(c_name = "move_importance",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add the insertion/removal of two operators with indices and time difference drawn according to |Delta_ab(tau)|""")
+
+c.add_member(c_name = "move_importance_prob",
+             c_type = "double",
+             initializer = """ 1.0 """,
+             doc = """Probability of the importance sampled insertion/removal of two operators""")
+
+c.add_member(c_name = "move_importance_mixing",
+             c_type = "double",
+             initializer = """ 0.1 """,
+             doc = """Fraction of the importance sampled proposals drawn uniformly""")
+
+c.add_member(c_name = "move_double_prune",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Restrict the proposals of the insertion/removal of four operators to the quadruples closing an atomic subspace, and drop the pairs of blocks without any""")
+
+c.add_member(c_name = "move_shift_window",
+             c_type = "double",
+             initializer = """ 0.0 """,
+             doc = """Width of the local shift of one operator around its time (0: uniform between the neighbouring operators of the block)""")
+
+c.add_member(c_name = "move_shift_gaussian",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Draw the local shift from a Gaussian of standard deviation move_shift_window instead of uniformly in [-move_shift_window, move_shift_window]""")
+
+c.add_member(c_name = "move_pair_shift",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add the rigid shift of a C, C^dagger pair of a block""")
+
+c.add_member(c_name = "move_pair_shift_window",
+             c_type = "double",
+             initializer = """ 0.0 """,
+             doc = """Largest shift of a C, C^dagger pair (0: beta / n, the mean distance between the n C^dagger of the block)""")
+
+c.add_member(c_name = "move_flavour_change",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Add the change of the inner indices of a C, C^dagger pair of a block, at fixed times""")
+
+c.add_member(c_name = "n_walkers",
+             c_type = "int",
+             initializer = """ 1 """,
+             doc = """Number of Markov chains of each MPI process, run on threads sharing the atomic problem and Delta""")
+
+c.add_member(c_name = "results_on_all_ranks",
+             c_type = "bool",
+             initializer = """ true """,
+             doc = """Reduce the results to all MPI ranks. If false, they are only reduced to rank 0 and undefined on the other ranks""")
+
+c.add_member(c_name = "async_reduction",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Reduce the blocks of the two-particle Green's functions with non-blocking MPI calls, overlapped with their normalisation""")
+
+c.add_member(c_name = "load_balancing",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Share the n_cycles cycles of all ranks among the ranks according to their speed, so that they finish together""")
+
+c.add_member(c_name = "load_balancing_interval",
+             c_type = "double",
+             initializer = """ 1.0 """,
+             doc = """Seconds between two exchanges of the progress of the ranks (load_balancing = True)""")
+
+c.add_member(c_name = "checkpoint_file",
+             c_type = "std::string",
+             initializer = """ "" """,
+             doc = """Write checkpoints of the accumulation to this HDF5 file (suffixed by the rank if more than one), empty for none""")
+
+c.add_member(c_name = "checkpoint_interval_cycles",
+             c_type = "int",
+             initializer = """ 0 """,
+             doc = """Measured cycles between two checkpoints, 0 for no limit""")
+
+c.add_member(c_name = "checkpoint_interval_time",
+             c_type = "double",
+             initializer = """ 600.0 """,
+             doc = """Seconds between two checkpoints, 0 for no limit""")
+
+c.add_member(c_name = "checkpoint_restart",
+             c_type = "bool",
+             initializer = """ false """,
+             doc = """Continue from the checkpoints in checkpoint_file, if all ranks have one. The RNG state is not saved: a restart uses a new seed, it is not a continuation of the chain""")
+
+c.add_member(c_name = "replica_exchange_h_int_scales",
+             c_type = "std::vector<double>",
+             initializer = """ std::vector<double>{} """,
+             doc = """Factors of h_int of the further replicas of the replica exchange, from the nearest to the target (1) on; empty for none""")
+
+c.add_member(c_name = "replica_exchange_interval",
+             c_type = "int",
+             initializer = """ 10 """,
+             doc = """Cycles of the further replicas between two exchanges""")
+
+c.add_member(c_name = "replica_exchange_prob",
+             c_type = "double",
+             initializer = """ 0.05 """,
+             doc = """Proposal probability of the exchange of configurations with the nearest replica""")
+
+c.add_member(c_name = "warmup_seed_ranks",
+             c_type = "int",
+             initializer = """ 0 """,
+             doc = """Number of ranks which thermalise from the empty configuration and broadcast it to the other ranks, 0 for none""")
+
+c.add_member(c_name = "warmup_seed_cycles",
+             c_type = "int",
+             initializer = """ 100 """,
+             doc = """Warmup cycles of the other ranks from the configuration broadcast by their seed rank""")
+
+c.add_member(c_name = "measure_G2_n_threads",
+             c_type = "int",
+             initializer = """ 1 """,
+             doc = """Number of threads sharing the block pairs (and the NFFT of the blocks) of the two-particle measurements""")
+
+c.add_member(c_name = "measure_pipeline_depth",
+             c_type = "int",
+             initializer = """ 0 """,
+             doc = """Snapshots buffered for the two-particle measurements, which are then accumulated on a worker thread; 0 to accumulate them on the sampling thread""")
+
+c.add_member(c_name = "trace_rebuild_threads",
+             c_type = "int",
+             initializer = """ 1 """,
+             doc = """Threads sharing a full rebuild of the trace tree (warm starts, checkpoints, global moves); 1 for serial, at most the number of hardware threads""")
+
+c.add_member(c_name = "move_transform_prob",
+             c_type = "double",
+             initializer = """ 0.005 """,
+             doc = """Overall probability of the time shift, time reflection and particle-hole moves, which cost a full refill of the dets and rebuild of the trace""")
+
+c.add_member(c_name = "checkpoint_G2",
+             c_type = "bool",
+             initializer = """ true """,
+             doc = """Also checkpoint the two-particle accumulators, copied at every checkpoint (else a restart only holds the G2 cycles measured since then)""")
+
 module.add_converter(c)
 
 # Converter for constr_parameters_t
@@ -0,0 +1,50 @@
+#include <triqs_cthyb/config_stream.hpp>
+#include <triqs/test_tools/arrays.hpp>
+
+using namespace triqs_cthyb;
+
+TEST(CtHyb, ConfigStream) {
+
+  double beta = 10.0;
+  time_segment tau_seg(beta);
+
+  // Two blocks of size 2, 1 and the corresponding linear indices
+  std::vector<std::pair<int, int>> lin_to_block_inner{{0, 0}, {0, 1}, {1, 0}};
+
+  std::vector<std::vector<std::pair<double, op_desc>>> ref{
+     {},
+     {{7.5, {0, 1, true, 1}}, {2.25, {0, 0, false, 0}}},
+     {{9.999, {1, 0, false, 2}}, {5.0, {0, 0, true, 0}}, {4.999999, {1, 0, true, 2}}, {0.001, {0, 0, false, 0}}}};
+  std::vector<long> steps{3, 10, 1000000};
+
+  {
+    // A tiny buffer size to go through the background writer several times
+    config_stream_writer writer("config_stream.bin", beta, lin_to_block_inner, 16);
+    for (int n = 0; n < ref.size(); ++n) {
+      configuration config(beta);
+      for (auto const &[tau, op] : ref[n]) config.insert(tau_seg.make_time_pt(tau), op);
+      writer.write(config, steps[n]);
+    }
+    EXPECT_EQ(writer.n_records(), long(ref.size()));
+  }
+
+  config_stream_reader reader("config_stream.bin");
+  EXPECT_EQ(reader.beta(), beta);
+
+  config_stream_record rec;
+  for (int n = 0; n < ref.size(); ++n) {
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.step, steps[n]);
+    ASSERT_EQ(rec.ops.size(), ref[n].size());
+    for (int i = 0; i < rec.ops.size(); ++i) {
+      EXPECT_NEAR(rec.ops[i].first, ref[n][i].first, 1e-12 * beta);
+      EXPECT_EQ(rec.ops[i].second.block_index, ref[n][i].second.block_index);
+      EXPECT_EQ(rec.ops[i].second.inner_index, ref[n][i].second.inner_index);
+      EXPECT_EQ(rec.ops[i].second.dagger, ref[n][i].second.dagger);
+      EXPECT_EQ(rec.ops[i].second.linear_index, ref[n][i].second.linear_index);
+    }
+  }
+  EXPECT_FALSE(reader.next(rec));
+}
+
+MAKE_MAIN;
@@ -0,0 +1,70 @@
+#include <triqs_cthyb/det_blocks.hpp>
+#include <triqs/test_tools/gfs.hpp>
+#include <triqs/operators/many_body_operator.hpp>
+
+using namespace triqs_cthyb;
+using triqs::operators::c;
+using triqs::operators::c_dag;
+using triqs::operators::n;
+
+TEST(CtHyb, DetBlocks) {
+
+  double beta = 10.0;
+  gf_struct_t gf_struct{{"ud", {0, 1, 2, 3}}, {"x", {0}}};
+  auto delta = block_gf<imtime>{{beta, Fermion, 11}, gf_struct};
+
+  // Orbitals (0,2) and (1,3) are coupled, 0 and 1 only weakly
+  delta() = 0;
+  for (auto const &t : delta[0].mesh()) {
+    auto &d = delta[0];
+    for (int i : range(4)) d[t](i, i) = -0.5;
+    d[t](0, 2) = d[t](2, 0) = -0.1 * double(t);
+    d[t](1, 3) = d[t](3, 1) = -0.2;
+    d[t](0, 1) = d[t](1, 0) = -1e-7;
+  }
+  delta[1]() = -0.3;
+
+  // Density-density interaction does not couple the orbitals
+  many_body_op_t h_loc = 2.0 * n<h_scalar_t>("ud", 0) * n<h_scalar_t>("ud", 1) + 2.0 * n<h_scalar_t>("ud", 2) * n<h_scalar_t>("x", 0);
+
+  // No splitting (the threshold is relative to max|Delta| = 1)
+  auto s0 = make_det_block_structure(gf_struct, delta, 1e-8, h_loc);
+  EXPECT_FALSE(s0.is_split);
+  EXPECT_EQ(s0.gf_struct.size(), 2);
+
+  // A hopping in h_loc between 0 and 1 merges the two groups
+  auto h_hop = h_loc + 0.1 * (c_dag<h_scalar_t>("ud", 0) * c<h_scalar_t>("ud", 1) + c_dag<h_scalar_t>("ud", 1) * c<h_scalar_t>("ud", 0));
+  auto s1    = make_det_block_structure(gf_struct, delta, 1e-5, h_hop);
+  EXPECT_FALSE(s1.is_split);
+
+  // So does a pair hopping between 0 and 3
+  auto h_pair = h_loc + c_dag<h_scalar_t>("ud", 0) * c_dag<h_scalar_t>("ud", 2) * c<h_scalar_t>("ud", 3) * c<h_scalar_t>("ud", 1);
+  EXPECT_FALSE(make_det_block_structure(gf_struct, delta, 1e-5, h_pair).is_split);
+
+  // The threshold is relative to the largest element
+  auto delta_scaled = delta;
+  delta_scaled[0].data() *= 1e-3;
+  EXPECT_TRUE(make_det_block_structure(gf_struct, delta_scaled, 1e-5, h_loc).is_split);
+  EXPECT_FALSE(make_det_block_structure(gf_struct, delta_scaled, 1e-8, h_loc).is_split);
+
+  auto s = make_det_block_structure(gf_struct, delta, 1e-5, h_loc);
+  EXPECT_TRUE(s.is_split);
+  ASSERT_EQ(s.gf_struct.size(), 3);
+  EXPECT_EQ(s.gf_block_name, (std::vector<std::string>{"ud", "ud", "x"}));
+  EXPECT_EQ(s.gf_block, (std::vector<int>{0, 0, 1}));
+  EXPECT_EQ(s.inner, (std::vector<std::vector<int>>{{0, 2}, {1, 3}, {0}}));
+
+  // Restriction and back
+  auto delta_det = restrict_to_det_blocks<imtime, matrix_valued>(delta, s);
+  EXPECT_EQ(delta_det.block_names(), (std::vector<std::string>{"ud_0", "ud_1", "x"}));
+  EXPECT_ARRAY_NEAR(delta_det[0].data()(range(), 0, 1), delta[0].data()(range(), 0, 2));
+  EXPECT_ARRAY_NEAR(delta_det[1].data()(range(), 1, 1), delta[0].data()(range(), 3, 3));
+
+  auto back = delta;
+  scatter_det_blocks<imtime, matrix_valued>(back, delta_det, s);
+  delta[0].data()(range(), 0, 1) = 0;
+  delta[0].data()(range(), 1, 0) = 0;
+  for (int b : range(2)) EXPECT_ARRAY_NEAR(back[b].data(), delta[b].data());
+}
+
+MAKE_MAIN;
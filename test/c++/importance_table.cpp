@@ -0,0 +1,59 @@
+#include <triqs_cthyb/moves/importance_table.hpp>
+#include <triqs/mc_tools/random_generator.hpp>
+#include <triqs/test_tools/arrays.hpp>
+
+using namespace triqs_cthyb;
+
+TEST(CtHyb, AliasTable) {
+
+  std::vector<double> weights{1.0, 0.0, 3.0, 0.5, 5.5};
+  alias_table table(weights);
+  triqs::mc_tools::random_generator rng("mt19937", 1234);
+
+  int n_draws = 1000000;
+  std::vector<int> counts(weights.size(), 0);
+  for (int n = 0; n < n_draws; ++n) ++counts[table(rng)];
+
+  for (int i = 0; i < weights.size(); ++i) {
+    EXPECT_NEAR(table.prob(i), weights[i] / 10.0, 1e-14);
+    EXPECT_NEAR(double(counts[i]) / n_draws, weights[i] / 10.0, 3e-3);
+  }
+  EXPECT_EQ(counts[1], 0);
+}
+
+TEST(CtHyb, HybImportanceTable) {
+
+  // Diagonal hybridization, decaying from both ends of [0, beta]
+  double beta = 10.0, mixing = 0.2;
+  gf<imtime, delta_target_t> delta{{beta, Fermion, 201}, {2, 2}};
+  delta() = 0;
+  for (auto const &t : delta.mesh()) {
+    double tau = t;
+    delta[t](0, 0) = -0.5 * (std::exp(-tau) + std::exp(-(beta - tau)));
+    delta[t](1, 1) = -0.25 * (std::exp(-2 * tau) + std::exp(-2 * (beta - tau)));
+  }
+  hyb_importance_table table(delta, mixing);
+  triqs::mc_tools::random_generator rng("mt19937", 1234);
+
+  // Only the uniform part reaches the vanishing off-diagonal components : mixing / 2
+  int n_draws = 200000, n_offdiag = 0;
+  for (int n = 0; n < n_draws; ++n) {
+    auto d = table(rng);
+    ASSERT_TRUE(d.tau >= 0 && d.tau < beta);
+    if (d.a != d.b) ++n_offdiag;
+  }
+  EXPECT_NEAR(double(n_offdiag) / n_draws, mixing / 2, 5e-3);
+
+  // The density is normalized
+  int n_steps = 20000;
+  double norm = 0;
+  for (int a = 0; a < 2; ++a)
+    for (int b = 0; b < 2; ++b)
+      for (int k = 0; k < n_steps; ++k) norm += table.density(a, b, (k + 0.5) * beta / n_steps) * beta / n_steps;
+  EXPECT_NEAR(norm, 1.0, 1e-10);
+
+  // The off-diagonal density is the uniform one
+  EXPECT_NEAR(table.density(0, 1, 3.3), mixing / 4 / beta, 1e-12);
+}
+
+MAKE_MAIN;
@@ -0,0 +1,112 @@
+#include <triqs_cthyb/measures/pipeline.hpp>
+
+#include <triqs/operators/many_body_operator.hpp>
+#include <triqs/hilbert_space/fundamental_operator_set.hpp>
+#include <triqs/gfs.hpp>
+#include <triqs/test_tools/gfs.hpp>
+
+#include <random>
+
+using namespace triqs_cthyb;
+using triqs::operators::n;
+using namespace triqs::gfs;
+using triqs::hilbert_space::fundamental_operator_set;
+using triqs::hilbert_space::gf_struct_t;
+
+// Sums the sign times the elements of the inverse matrices of the dets it reads, weighted by their times, and the sizes
+// of the dets : the pipelined measure reads the snapshots of the pipeline, as the two-particle measures do
+template <typename Dets> struct fake_measure {
+  qmc_data const &data;
+  Dets const &dets;
+  mc_weight_t *sum;
+  long *n_ops;
+  bool *collected;
+
+  void accumulate(mc_weight_t s) {
+    for (auto const &det : dets) {
+      foreach (det, [&](op_t const &x, op_t const &y, det_scalar_t M) {
+        *sum += s * data.atomic_reweighting * M * (1 + double(x.first) - 0.5 * double(y.first));
+      })
+        ;
+      *n_ops += det.size();
+    }
+  }
+  void collect_results(triqs::mpi::communicator const &) { *collected = true; }
+};
+template <typename Dets> fake_measure(qmc_data const &, Dets const &, mc_weight_t *, long *, bool *) -> fake_measure<Dets>;
+
+// Feed random configurations through pipelines of several depths, and compare with a direct measurement
+TEST(CtHyb, MeasurePipeline) {
+
+  double beta = 10.0, U = 2.0, mu = 1.0, V = 1.0;
+  gf_struct_t gf_struct{{"up", {0}}, {"down", {0}}};
+
+  fundamental_operator_set fops;
+  std::map<std::pair<int, int>, int> linindex;
+  for (auto const &bl : gf_struct) fops.insert(bl.first, 0);
+  linindex[{0, 0}] = fops[{"up", 0}];
+  linindex[{1, 0}] = fops[{"down", 0}];
+
+  auto h_loc = U * n("up", 0) * n("down", 0) - mu * (n("up", 0) + n("down", 0));
+  atom_diag h_diag(h_loc, fops);
+
+  // Hybridization with a few bath levels
+  auto delta = block_gf<imtime>{{beta, Fermion, 1001}, gf_struct};
+  std::vector<double> eps{-1.5, -0.5, 0.3, 1.1};
+  for (auto &d : delta)
+    for (auto const &t : d.mesh()) {
+      double r = 0;
+      for (auto e : eps) r -= V * V / eps.size() * std::exp(-e * double(t)) / (1 + std::exp(-beta * e));
+      d[t] = r;
+    }
+
+  solve_parameters_t p(h_loc, 0);
+  qmc_data data(beta, p, h_diag, linindex, delta, {1, 1}, nullptr);
+
+  std::mt19937 gen(1234);
+  std::vector<config_snapshot_t> configs;
+  for (int c = 0; c < 200; ++c) {
+    int order = 1 + c % 7;
+    config_snapshot_t ops;
+    for (int b = 0; b < 2; ++b) {
+      std::vector<double> taus(2 * order);
+      std::uniform_real_distribution<double> dist(0.0, beta);
+      for (auto &t : taus) t = dist(gen);
+      std::sort(taus.begin(), taus.end(), std::greater<>{});
+      for (int i = 0; i < 2 * order; ++i) ops.emplace_back(taus[i], op_desc{b, 0, i % 2 == 0, linindex[{b, 0}]});
+    }
+    std::sort(ops.begin(), ops.end(), [](auto const &x, auto const &y) { return x.first > y.first; });
+    configs.push_back(ops);
+  }
+
+  // Direct measurement
+  mc_weight_t ref_sum = 0;
+  long ref_ops        = 0;
+  bool collected      = false;
+  fake_measure direct{data, data.dets, &ref_sum, &ref_ops, &collected};
+  for (auto const &ops : configs) {
+    if (!data.load_configuration(ops)) continue;
+    direct.accumulate(data.mc_sign());
+  }
+
+  triqs::mpi::communicator world;
+  for (int depth : {1, 4, 64}) {
+    measure_pipeline pipeline(data, p, depth);
+    mc_weight_t sum = 0;
+    long n_ops      = 0;
+    collected       = false;
+    pipeline.add(fake_measure{pipeline.shadow(), pipeline.dets(), &sum, &n_ops, &collected});
+    for (auto const &ops : configs) {
+      if (!data.load_configuration(ops)) continue;
+      pipeline.accumulate(data.mc_sign());
+    }
+    pipeline.collect_results(world);
+
+    EXPECT_TRUE(collected);
+    EXPECT_EQ(n_ops, ref_ops);
+    EXPECT_NEAR(std::abs(sum - ref_sum), 0.0, 1e-10 * std::abs(ref_sum));
+    EXPECT_LE(pipeline.n_synchronous(), pipeline.n_snapshots());
+  }
+}
+
+MAKE_MAIN;
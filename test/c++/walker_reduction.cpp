@@ -0,0 +1,49 @@
+#include <triqs_cthyb/measures/walker_reduction.hpp>
+#include <triqs/test_tools/arrays.hpp>
+
+using namespace triqs_cthyb;
+
+// Stands for the mc_generic of a walker, with the accumulators of a few measures
+struct fake_walker {
+  walker_reduction &reduction;
+  double z;
+  std::vector<matrix<double>> dm;
+  histogram histo{0, 10};
+  double z_collected = 0;
+
+  fake_walker(walker_reduction &reduction, double x) : reduction(reduction), z(x), dm(2, matrix<double>{{x, 0}, {0, 2 * x}}) { histo << int(x); }
+
+  void collect_results(triqs::mpi::communicator const &c) {
+    reduction.reduce(z, c);
+    reduction.reduce(dm, c);
+    reduction.reduce(histo, c);
+    if (reduction.merging()) return;
+    z_collected = z;
+  }
+};
+
+TEST(CtHyb, WalkerReduction) {
+
+  triqs::mpi::communicator world;
+  int n_ranks = world.size();
+
+  walker_reduction reduction;
+  std::vector<fake_walker> walkers{{reduction, 1.0}, {reduction, 2.0}, {reduction, 3.0}};
+  reduction.merge(walkers[1], world);
+  reduction.merge(walkers[2], world);
+  reduction.finish(walkers[0], world);
+
+  // The merged walkers are not normalised, the first one has the sum over walkers and ranks
+  EXPECT_EQ(walkers[1].z_collected, 0.0);
+  EXPECT_EQ(walkers[0].z_collected, 6.0 * n_ranks);
+  EXPECT_ARRAY_NEAR(walkers[0].dm[1], (matrix<double>{{6.0 * n_ranks, 0}, {0, 12.0 * n_ranks}}));
+  EXPECT_EQ(walkers[0].histo.n_data_pts(), 3 * n_ranks);
+  for (int k = 1; k <= 3; ++k) EXPECT_EQ(walkers[0].histo.data()[k], n_ranks);
+
+  // Without a reduction in progress, this is a plain MPI reduction
+  fake_walker single(reduction, 1.0);
+  single.collect_results(world);
+  EXPECT_EQ(single.z_collected, 1.0 * n_ranks);
+}
+
+MAKE_MAIN;
@@ -0,0 +1,107 @@
+# The two-orbital Kanamori model of kanamori.py, solved with additional moves enabled.
+#
+# The moves change the Markov chain, so that the results can not be compared exactly with a reference file.
+# Instead, the model is solved n_runs times with independent seeds, with the moves and with the default moves
+# only, and the mean Legendre Green's functions of both sets of runs are compared within their statistical
+# error, estimated from the spread of the runs.
+import numpy as np
+import pytriqs.utility.mpi as mpi
+from pytriqs.gf import *
+from pytriqs.operators.util.hamiltonians import h_int_kanamori
+from pytriqs.operators.util.op_struct import set_operator_structure
+from pytriqs.archive import HDFArchive
+from triqs_cthyb import *
+
+# Independent runs of each set of moves, and their length
+n_runs = 8
+n_cycles = 2500
+
+# Largest mean, over the Legendre coefficients, of the squared difference of the means in units of its standard error.
+# With the errors estimated from 2 x n_runs runs, each squared deviation follows a squared Student distribution with
+# about 2 n_runs - 2 = 14 degrees of freedom, whose mean is 14 / 12. Even if all the coefficients were fully correlated,
+# the mean would exceed 4 with a probability of 1e-3 only; a bias of the moves of a few standard errors exceeds it.
+chi2_tolerance = 4.0
+
+def solve_kanamori_once(seed, **moves):
+
+    # H_loc parameters
+    beta = 10.0
+    num_orbitals = 2
+    mu = 1.0
+    U = 2.0
+    J = 0.2
+
+    # Poles of delta
+    epsilon = 2.3
+
+    # Hybridization matrices
+    V = 1.0 * np.eye(num_orbitals) + 0.1 * (np.ones(num_orbitals) - np.eye(num_orbitals))
+
+    # Block structure of GF
+    spin_names = ('up','down')
+    orb_names = range(num_orbitals)
+    gf_struct = set_operator_structure(spin_names,orb_names,True)
+
+    # Construct solver
+    S = Solver(beta=beta, gf_struct=gf_struct, n_iw=1025, n_tau=2500, n_l=50)
+
+    # Hamiltonian
+    H = h_int_kanamori(spin_names,orb_names,
+                       np.array([[0,U-3*J],[U-3*J,0]]),
+                       np.array([[U,U-2*J],[U-2*J,U]]),
+                       J,True)
+
+    # Set hybridization function
+    delta_w = GfImFreq(indices = orb_names, beta=beta)
+    delta_w << inverse(iOmega_n - epsilon) + inverse(iOmega_n + epsilon)
+    delta_w.from_L_G_R(V, delta_w, V)
+    S.G0_iw << inverse(iOmega_n + mu - delta_w)
+
+    # Parameters
+    p = {}
+    p["max_time"] = -1
+    p["random_name"] = ""
+    p["random_seed"] = seed
+    p["length_cycle"] = 50
+    p["n_warmup_cycles"] = 200
+    p["n_cycles"] = n_cycles
+    p["measure_g_l"] = True
+    p["move_double"] = False
+    p.update(moves)
+
+    S.solve(h_int=H, **p)
+    return S
+
+def solve_kanamori(**moves):
+    """The solvers of n_runs runs with the given moves, with independent seeds"""
+    return [solve_kanamori_once(123 * mpi.rank + 567 + 7919 * run, **moves) for run in range(n_runs)]
+
+# The runs with the default moves, shared by the checks of a test, with seeds disjoint from those of solve_kanamori
+reference_runs = None
+
+def legendre_coefficients(runs):
+    """The Legendre coefficients of all blocks of each run, as the rows of an array"""
+    return np.array([np.concatenate([g.data.ravel() for name, g in S.G_l]) for S in runs])
+
+def check_kanamori(runs, name, reference = None):
+    """Check that the mean G_l of runs agrees with that of the reference runs (by default, the default moves)"""
+    global reference_runs
+    if reference is None:
+        if reference_runs is None:
+            reference_runs = [solve_kanamori_once(123 * mpi.rank + 567 + 7919 * (n_runs + run)) for run in range(n_runs)]
+        reference = reference_runs
+
+    a, b = legendre_coefficients(runs), legendre_coefficients(reference)
+    diff = a.mean(axis = 0) - b.mean(axis = 0)
+    error = np.sqrt(a.var(axis = 0, ddof = 1) / len(a) + b.var(axis = 0, ddof = 1) / len(b))
+
+    if mpi.is_master_node():
+        with HDFArchive(name + ".out.h5",'w') as Results:
+            Results["G_leg_mean"] = a.mean(axis = 0)
+            Results["G_leg_error"] = np.sqrt(a.var(axis = 0, ddof = 1) / len(a))
+
+    # Coefficients without noise (e.g. vanishing by symmetry) must agree exactly
+    noisy = error > 1e-10 * error.max()
+    assert np.all(np.abs(diff[~noisy]) < 1e-10), "%s: coefficients without noise differ" % name
+    chi2 = np.mean(np.abs(diff[noisy] / error[noisy])**2)
+    assert chi2 < chi2_tolerance, "%s: mean squared deviation of G_l of %g standard errors^2" % (name, chi2)
@@ -0,0 +1,12 @@
+# The insertion/removal of four operators restricted to the quadruples allowed by the atomic problem
+# must reproduce the unrestricted moves (and the results of the default moves).
+from kanamori_moves import *
+
+S_full = solve_kanamori(move_double = True)
+S_pruned = solve_kanamori(move_double = True, move_double_prune = True)
+
+check_kanamori(S_full, "move_double")
+check_kanamori(S_pruned, "move_double_prune")
+
+# Both sets of runs are noisy: the bound comes from their combined standard errors
+check_kanamori(S_pruned, "move_double_prune_vs_full", reference = S_full)
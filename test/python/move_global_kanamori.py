@@ -0,0 +1,13 @@
+# Global moves substituting indices of the operators, with the ratio of the dets computed by low-rank updates or refills
+from kanamori_moves import *
+
+gm = {}
+gm['flip_spins'] = {("up",0) : ("down",0), ("down",0) : ("up",0), ("up",1) : ("down",1), ("down",1) : ("up",1)}
+gm['swap_orbs']  = {("up",0) : ("up",1), ("up",1) : ("up",0), ("down",0) : ("down",1), ("down",1) : ("down",0)}
+gm['flip_spin_0'] = {("up",0) : ("down",0), ("down",0) : ("up",0)}
+
+S_refill = solve_kanamori(move_global = gm, move_global_prob = 0.1)
+check_kanamori(S_refill, "move_global_refill")
+
+S_woodbury = solve_kanamori(move_global = gm, move_global_prob = 0.1, move_global_woodbury_rank = 4)
+check_kanamori(S_woodbury, "move_global_woodbury")
@@ -0,0 +1,5 @@
+# Insertion/removal of a pair of operators with indices and time difference drawn according to |Delta(tau)|
+from kanamori_moves import *
+
+S = solve_kanamori(move_importance = True)
+check_kanamori(S, "move_importance")
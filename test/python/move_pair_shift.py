@@ -0,0 +1,8 @@
+# Rigid shift of a C, C^dagger pair and change of its inner indices, with the default and a fixed window
+from kanamori_moves import *
+
+S = solve_kanamori(move_pair_shift = True, move_flavour_change = True)
+check_kanamori(S, "move_pair_shift")
+
+S_window = solve_kanamori(move_pair_shift = True, move_pair_shift_window = 2.0)
+check_kanamori(S_window, "move_pair_shift_window")
@@ -0,0 +1,5 @@
+# Time shift, time reflection and particle-hole transformation of the whole configuration
+from kanamori_moves import *
+
+S = solve_kanamori(move_time_shift = True, move_time_reflection = True, move_particle_hole = True, move_transform_prob = 0.05)
+check_kanamori(S, "move_transform")
@@ -0,0 +1,5 @@
+# Insertion/removal of a pair of operators within a window, together with the uniform ones
+from kanamori_moves import *
+
+S = solve_kanamori(move_window_length = 1.0)
+check_kanamori(S, "move_window")
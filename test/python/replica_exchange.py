@@ -0,0 +1,11 @@
+# Replica exchange with a replica of weaker interaction, the results being those of the target
+from kanamori_moves import *
+
+S = solve_kanamori(replica_exchange_h_int_scales = [0.5], replica_exchange_prob = 0.1)
+check_kanamori(S, "replica_exchange")
+
+# The determinants are exchanged with the configurations and stay under drift control in every replica
+S = solve_kanamori(replica_exchange_h_int_scales = [0.5], replica_exchange_prob = 0.1, det_check_interval = 10)
+check_kanamori(S, "replica_exchange_det_drift")
+drift = max(run.det_drift_max for run in S)
+assert drift < 1e-6, "Determinant drift %g with replica exchange" % drift
@@ -0,0 +1,5 @@
+# Several Markov chains per process sharing the atomic problem
+from kanamori_moves import *
+
+S = solve_kanamori(n_walkers = 2)
+check_kanamori(S, "walkers")